@@ -0,0 +1,722 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BATCH_H_
+#define BATCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "clamping.h"
+#include "in_range.h"
+#include "is_integral.h"
+#include "overflow_status.h"
+#include "span.h"
+#include "trap.h"
+#include "trapping.h"
+
+namespace integers {
+
+/// ## Overflow Masks
+///
+/// The batch checking operations below report which elements overflowed as a
+/// packed bitmask: bit `i % 64` of `mask[i / 64]` is set if element `i`
+/// overflowed.
+///
+/// ### `overflow_mask_size`
+///
+/// Returns the number of `uint64_t`s needed for the mask of `count` elements.
+constexpr size_t overflow_mask_size(size_t count) {
+  return count / 64 + (count % 64 != 0);
+}
+
+/// ### `find_first_overflow`
+///
+/// Returns the index of the first element whose bit is set in `mask`, or
+/// `count` if none is.
+inline size_t find_first_overflow(span<const uint64_t> mask, size_t count) {
+  const size_t words = std::min(mask.size(), overflow_mask_size(count));
+  for (size_t word = 0; word < words; word++) {
+    if (mask[word] != 0) {
+      size_t i = word * 64;
+      for (uint64_t bits = mask[word]; (bits & 1) == 0; bits >>= 1) {
+        i++;
+      }
+      return std::min(i, count);
+    }
+  }
+  return count;
+}
+
+/// ### `find_last_overflow`
+///
+/// Returns the index of the last element whose bit is set in `mask`, or
+/// `count` if none is.
+inline size_t find_last_overflow(span<const uint64_t> mask, size_t count) {
+  for (size_t word = std::min(mask.size(), overflow_mask_size(count));
+       word-- > 0;) {
+    uint64_t bits = mask[word];
+    if (word * 64 + 64 > count) {
+      // Ignore bits past `count`.
+      bits &= (uint64_t{1} << (count % 64)) - 1;
+    }
+    if (bits != 0) {
+      size_t i = word * 64 + 63;
+      for (; (bits >> 63) == 0; bits <<= 1) {
+        i--;
+      }
+      return i;
+    }
+  }
+  return count;
+}
+
+}  // namespace integers
+
+namespace internal {
+
+// The number of elements that the batch operations process between checks of
+// the overflow flag. Small enough that a chunk of results stays in L1 cache;
+// large enough that the check is rare.
+constexpr size_t kBatchChunk = 1024;
+
+// Returns the `i`th element of a batch operand, which is either a span or a
+// scalar broadcast to every element.
+template <typename T>
+T batch_element(integers::span<const T> x, size_t i) {
+  return x[i];
+}
+
+template <typename T>
+T batch_element(T x, size_t) {
+  return x;
+}
+
+template <typename T>
+size_t batch_size(integers::span<const T> x) {
+  return x.size();
+}
+
+template <typename T>
+constexpr size_t batch_size(T) {
+  return SIZE_MAX;
+}
+
+// Applies `op(x[i], y[i], &result[i])`, which returns true on overflow, to
+// each element. Stops at the first element that overflows and returns its
+// index, or returns `result.size()` if none does. Elements before that index
+// are written, and no others are.
+//
+// The loops over each chunk have no branches, so compilers can vectorize them.
+// Results go to a buffer first, so that `result` may alias `x` or `y` (when
+// finding the overflowing element requires re-reading them).
+template <typename T, typename X, typename Y, typename Op>
+size_t batch_until_overflow(X x, Y y, integers::span<T> result, Op op) {
+  if (batch_size(x) < result.size() || batch_size(y) < result.size()) {
+    trap();
+  }
+  T buffer[kBatchChunk];
+  for (size_t start = 0; start < result.size(); start += kBatchChunk) {
+    const size_t count = std::min(kBatchChunk, result.size() - start);
+    uint32_t overflow = 0;
+    for (size_t i = 0; i < count; i++) {
+      overflow |= op(batch_element(x, start + i), batch_element(y, start + i),
+                     &buffer[i]);
+    }
+    size_t good = count;
+    if (overflow) {
+      good = 0;
+      while (!op(batch_element(x, start + good),
+                 batch_element(y, start + good), &buffer[good])) {
+        good++;
+      }
+    }
+    std::copy(buffer, buffer + good, result.data() + start);
+    if (good != count) {
+      return start + good;
+    }
+  }
+  return result.size();
+}
+
+// Like `batch_until_overflow`, but writes every result (wrapping on overflow)
+// and returns true if any element overflowed.
+template <typename T, typename X, typename Y, typename Op>
+bool batch_any_overflow(X x, Y y, integers::span<T> result, Op op) {
+  if (batch_size(x) < result.size() || batch_size(y) < result.size()) {
+    trap();
+  }
+  uint32_t overflow = 0;
+  for (size_t i = 0; i < result.size(); i++) {
+    overflow |= op(batch_element(x, i), batch_element(y, i), &result[i]);
+  }
+  return overflow != 0;
+}
+
+// Like `batch_any_overflow`, but also sets bit `i % 64` of `mask[i / 64]` if
+// element `i` overflowed, and clears it if not.
+template <typename T, typename X, typename Y, typename Op>
+bool batch_overflow_mask(X x, Y y, integers::span<T> result,
+                         integers::span<uint64_t> mask, Op op) {
+  if (batch_size(x) < result.size() || batch_size(y) < result.size() ||
+      mask.size() < integers::overflow_mask_size(result.size())) {
+    trap();
+  }
+  uint8_t flags[kBatchChunk];
+  uint64_t any = 0;
+  for (size_t start = 0; start < result.size(); start += kBatchChunk) {
+    const size_t count = std::min(kBatchChunk, result.size() - start);
+    for (size_t i = 0; i < count; i++) {
+      flags[i] = op(batch_element(x, start + i), batch_element(y, start + i),
+                    &result[start + i]);
+    }
+    // Pack the flags, 8 at a time: the multiplication gathers bit 0 of each
+    // byte of `eight` into the top byte of the product, the flag in the low
+    // byte becoming the low bit. So `flags[k]` must be in byte k of `eight`,
+    // counting from the low end.
+    for (size_t i = count; i % 64 != 0; i++) {
+      flags[i] = 0;
+    }
+    for (size_t word = 0; word * 64 < count; word++) {
+      uint64_t bits = 0;
+      for (size_t byte = 0; byte < 8; byte++) {
+        uint64_t eight;
+        memcpy(&eight, &flags[word * 64 + byte * 8], sizeof(eight));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        eight = __builtin_bswap64(eight);
+#endif
+        bits |= ((eight * 0x0102040810204080u) >> 56) << (byte * 8);
+      }
+      mask[start / 64 + word] = bits;
+      any |= bits;
+    }
+  }
+  return any != 0;
+}
+
+// Applies `op` as described for the batch trapping operations below: traps at
+// the first overflow or, in sticky mode, records it as `flag`.
+template <typename T, typename X, typename Y, typename Op>
+void batch_trapping(X x, Y y, integers::span<T> result,
+                    integers::overflow_flags flag, Op op) {
+#if defined(INTEGERS_STICKY_OVERFLOW)
+  integers::record_overflow(batch_any_overflow(x, y, result, op), flag);
+#else
+  static_cast<void>(flag);
+  if (batch_until_overflow(x, y, result, op) != result.size()) {
+    trap();
+  }
+#endif
+}
+
+// Computes `result[i] = op(x[i], y[i])`.
+template <typename T, typename X, typename Y, typename Op>
+void batch_map(X x, Y y, integers::span<T> result, Op op) {
+  if (batch_size(x) < result.size() || batch_size(y) < result.size()) {
+    trap();
+  }
+  for (size_t i = 0; i < result.size(); i++) {
+    result[i] = op(batch_element(x, i), batch_element(y, i));
+  }
+}
+
+// Returns the minimum and maximum of `values`, which must not be empty. The
+// loop is a pair of reductions, which compilers vectorize.
+template <typename T>
+std::pair<T, T> batch_min_max(integers::span<const T> values) {
+  T lowest = values[0];
+  T highest = values[0];
+  for (const T x : values) {
+    lowest = std::min(lowest, x);
+    highest = std::max(highest, x);
+  }
+  return {lowest, highest};
+}
+
+// Computes `result[i] = static_cast<R>(value[i])`.
+template <typename R, typename T>
+void batch_narrow(integers::span<const T> value, integers::span<R> result) {
+  for (size_t i = 0; i < result.size(); i++) {
+    result[i] = static_cast<R>(value[i]);
+  }
+}
+
+// Truncates, ignoring the (broadcast, unused) second operand.
+template <typename R>
+struct batch_cast {
+  template <typename T>
+  bool operator()(T x, T, R* result) const {
+    *result = static_cast<R>(x);
+    return !integers::in_range<R>(x);
+  }
+};
+
+template <typename T>
+struct batch_add {
+  bool operator()(T x, T y, T* result) const {
+    return vector_add_overflow(x, y, result);
+  }
+};
+
+template <typename T>
+struct batch_sub {
+  bool operator()(T x, T y, T* result) const {
+    return vector_sub_overflow(x, y, result);
+  }
+};
+
+template <typename T>
+struct batch_mul {
+  bool operator()(T x, T y, T* result) const {
+    return vector_mul_overflow(x, y, result);
+  }
+};
+
+template <typename T>
+struct batch_clamping_add {
+  T operator()(T x, T y) const { return saturating_add(x, y); }
+};
+
+template <typename T>
+struct batch_clamping_sub {
+  T operator()(T x, T y) const { return saturating_sub(x, y); }
+};
+
+template <typename T>
+struct batch_clamping_mul {
+  T operator()(T x, T y) const { return saturating_mul(x, y); }
+};
+
+template <typename T>
+struct batch_clamping_mul_high {
+  T operator()(T x, T y) const { return integers::clamping_mul_high(x, y); }
+};
+
+template <typename T>
+struct batch_clamping_average {
+  T operator()(T x, T y) const { return integers::clamping_average(x, y); }
+};
+
+}  // namespace internal
+
+namespace integers {
+
+/// ## Batch Primitive Checking Operations
+///
+/// These functions apply `cast_truncate`, `add_overflow`, `sub_overflow`, and
+/// `mul_overflow` element-wise, like the batch trapping operations below, but
+/// never trap on overflow. Instead, they write every result (truncated or
+/// wrapped on overflow), set the bit for each element that overflowed in
+/// `overflow` (see Overflow Masks above), and return true if any did.
+/// Rejecting an element costs no more than accepting it, so you can validate
+/// a batch at full speed and then filter it with the mask, or report the bad
+/// elements with `find_first_overflow` and `find_last_overflow`.
+///
+/// `overflow` must have at least `overflow_mask_size(result.size())`
+/// elements, and the operands at least as many as `result`; if not, the
+/// functions `trap`.
+///
+/// ### `all_in_range`
+///
+/// Returns true if `R` can represent every element of `values`. This is a
+/// minimum/maximum reduction followed by two `in_range` checks, rather than a
+/// check per element, so it runs at close to memory bandwidth. (And if `R`
+/// can represent every `T`, it reads nothing.)
+template <typename R, typename T>
+bool all_in_range(span<const T> values) {
+  assert_is_integral(R);
+  assert_is_integral(T);
+  if constexpr (in_range<R>(std::numeric_limits<T>::min()) &&
+                in_range<R>(std::numeric_limits<T>::max())) {
+    return true;
+  } else {
+    if (values.empty()) {
+      return true;
+    }
+    const auto [lowest, highest] = internal::batch_min_max(values);
+    return in_range<R>(lowest) && in_range<R>(highest);
+  }
+}
+
+/// ### `cast_truncate`
+///
+/// Computes `result[i] = static_cast<R>(value[i])`, flagging the elements that
+/// `R` cannot represent.
+template <typename R, typename T>
+[[nodiscard]] bool cast_truncate(span<const T> value,
+                                 span<R> result,
+                                 span<uint64_t> overflow) {
+  assert_is_integral(R);
+  assert_is_integral(T);
+  return internal::batch_overflow_mask(value, T{0}, result, overflow,
+                                       internal::batch_cast<R>{});
+}
+
+/// ### `add_overflow`
+///
+/// Computes `result[i] = x[i] + y[i]`.
+template <typename T>
+[[nodiscard]] bool add_overflow(span<const T> x,
+                                span<const T> y,
+                                span<T> result,
+                                span<uint64_t> overflow) {
+  assert_is_integral(T);
+  return internal::batch_overflow_mask(x, y, result, overflow,
+                                       internal::batch_add<T>{});
+}
+
+/// ### `add_overflow`
+///
+/// Computes `result[i] = x[i] + y`.
+template <typename T>
+[[nodiscard]] bool add_overflow(span<const T> x,
+                                T y,
+                                span<T> result,
+                                span<uint64_t> overflow) {
+  assert_is_integral(T);
+  return internal::batch_overflow_mask(x, y, result, overflow,
+                                       internal::batch_add<T>{});
+}
+
+/// ### `sub_overflow`
+///
+/// Computes `result[i] = x[i] - y[i]`.
+template <typename T>
+[[nodiscard]] bool sub_overflow(span<const T> x,
+                                span<const T> y,
+                                span<T> result,
+                                span<uint64_t> overflow) {
+  assert_is_integral(T);
+  return internal::batch_overflow_mask(x, y, result, overflow,
+                                       internal::batch_sub<T>{});
+}
+
+/// ### `sub_overflow`
+///
+/// Computes `result[i] = x[i] - y`.
+template <typename T>
+[[nodiscard]] bool sub_overflow(span<const T> x,
+                                T y,
+                                span<T> result,
+                                span<uint64_t> overflow) {
+  assert_is_integral(T);
+  return internal::batch_overflow_mask(x, y, result, overflow,
+                                       internal::batch_sub<T>{});
+}
+
+/// ### `sub_overflow`
+///
+/// Computes `result[i] = x - y[i]`.
+template <typename T>
+[[nodiscard]] bool sub_overflow(T x,
+                                span<const T> y,
+                                span<T> result,
+                                span<uint64_t> overflow) {
+  assert_is_integral(T);
+  return internal::batch_overflow_mask(x, y, result, overflow,
+                                       internal::batch_sub<T>{});
+}
+
+/// ### `mul_overflow`
+///
+/// Computes `result[i] = x[i] * y[i]`.
+template <typename T>
+[[nodiscard]] bool mul_overflow(span<const T> x,
+                                span<const T> y,
+                                span<T> result,
+                                span<uint64_t> overflow) {
+  assert_is_integral(T);
+  return internal::batch_overflow_mask(x, y, result, overflow,
+                                       internal::batch_mul<T>{});
+}
+
+/// ### `mul_overflow`
+///
+/// Computes `result[i] = x[i] * y`.
+template <typename T>
+[[nodiscard]] bool mul_overflow(span<const T> x,
+                                T y,
+                                span<T> result,
+                                span<uint64_t> overflow) {
+  assert_is_integral(T);
+  return internal::batch_overflow_mask(x, y, result, overflow,
+                                       internal::batch_mul<T>{});
+}
+
+/// ## Batch Trapping Operations
+///
+/// These functions apply `trapping_cast`, `trapping_add`, `trapping_sub`, and
+/// `trapping_mul` element-wise to spans of `T`, or to a span and a scalar that
+/// is broadcast to every element, storing the results in `result`. You must
+/// give `T` explicitly when passing containers, since containers do not deduce
+/// spans:
+///
+///   std::vector<int32_t> a = ..., b = ..., sum(a.size());
+///   trapping_add<int32_t>(a, b, sum);
+///
+/// They check overflow with plain arithmetic and no branches in the inner
+/// loop, so that the compiler can vectorize them for whatever instruction set
+/// you target (e.g. with `-march=native`). When some element overflows, they
+/// locate the first one that does, write the results of the elements before
+/// it, and then `trap`. `result` may be one of the inputs, for in-place
+/// operation. The operands must have at least as many elements as `result`;
+/// if not, the functions `trap`.
+///
+/// If `INTEGERS_STICKY_OVERFLOW` is defined, these functions instead write
+/// every (wrapped) result, and record any overflow in the sticky overflow
+/// status. See overflow_status.h.
+///
+/// ### `trapping_cast`
+///
+/// Computes `result[i] = trapping_cast<R>(value[i])`. You must give both `R`
+/// and `T` when passing containers:
+///
+///   std::vector<int64_t> column = ...;
+///   std::vector<int32_t> narrow(column.size());
+///   trapping_cast<int32_t, int64_t>(column, narrow);
+///
+/// This validates each chunk of `value` with `all_in_range` and then narrows
+/// it in bulk, rather than checking and narrowing each element in turn.
+/// `result` must not overlap `value`.
+template <typename R, typename T>
+void trapping_cast(span<const T> value, span<R> result) {
+  assert_is_integral(R);
+  assert_is_integral(T);
+  if (value.size() < result.size()) {
+    trap();
+  }
+#if defined(INTEGERS_STICKY_OVERFLOW)
+  record_overflow(!all_in_range<R>(value.first(result.size())),
+                  overflow_flags::cast);
+  internal::batch_narrow(value, result);
+#else
+  for (size_t start = 0; start < result.size();
+       start += internal::kBatchChunk) {
+    const size_t count =
+        std::min(internal::kBatchChunk, result.size() - start);
+    const span<const T> chunk = value.subspan(start, count);
+    if (!all_in_range<R>(chunk)) {
+      size_t good = 0;
+      while (in_range<R>(chunk[good])) {
+        good++;
+      }
+      internal::batch_narrow(chunk, result.subspan(start, good));
+      trap();
+    }
+    internal::batch_narrow(chunk, result.subspan(start, count));
+  }
+#endif
+}
+
+/// ### `trapping_add`
+///
+/// Computes `result[i] = x[i] + y[i]`.
+template <typename T>
+void trapping_add(span<const T> x, span<const T> y, span<T> result) {
+  assert_is_integral(T);
+  internal::batch_trapping(x, y, result, overflow_flags::add,
+                           internal::batch_add<T>{});
+}
+
+/// ### `trapping_add`
+///
+/// Computes `result[i] = x[i] + y`.
+template <typename T>
+void trapping_add(span<const T> x, T y, span<T> result) {
+  assert_is_integral(T);
+  internal::batch_trapping(x, y, result, overflow_flags::add,
+                           internal::batch_add<T>{});
+}
+
+/// ### `trapping_sub`
+///
+/// Computes `result[i] = x[i] - y[i]`.
+template <typename T>
+void trapping_sub(span<const T> x, span<const T> y, span<T> result) {
+  assert_is_integral(T);
+  internal::batch_trapping(x, y, result, overflow_flags::sub,
+                           internal::batch_sub<T>{});
+}
+
+/// ### `trapping_sub`
+///
+/// Computes `result[i] = x[i] - y`.
+template <typename T>
+void trapping_sub(span<const T> x, T y, span<T> result) {
+  assert_is_integral(T);
+  internal::batch_trapping(x, y, result, overflow_flags::sub,
+                           internal::batch_sub<T>{});
+}
+
+/// ### `trapping_sub`
+///
+/// Computes `result[i] = x - y[i]`.
+template <typename T>
+void trapping_sub(T x, span<const T> y, span<T> result) {
+  assert_is_integral(T);
+  internal::batch_trapping(x, y, result, overflow_flags::sub,
+                           internal::batch_sub<T>{});
+}
+
+/// ### `trapping_mul`
+///
+/// Computes `result[i] = x[i] * y[i]`.
+template <typename T>
+void trapping_mul(span<const T> x, span<const T> y, span<T> result) {
+  assert_is_integral(T);
+  internal::batch_trapping(x, y, result, overflow_flags::mul,
+                           internal::batch_mul<T>{});
+}
+
+/// ### `trapping_mul`
+///
+/// Computes `result[i] = x[i] * y`.
+template <typename T>
+void trapping_mul(span<const T> x, T y, span<T> result) {
+  assert_is_integral(T);
+  internal::batch_trapping(x, y, result, overflow_flags::mul,
+                           internal::batch_mul<T>{});
+}
+
+/// ## Batch Clamping Operations
+///
+/// These functions apply `clamping_cast`, `clamping_add`, `clamping_sub`,
+/// `clamping_mul`, `clamping_mul_high`, and `clamping_average` element-wise,
+/// like the batch trapping operations above, for e.g. compositing `uint8_t`
+/// pixels and mixing `int16_t` audio samples. They have no branches, and
+/// compilers vectorize them. `result` may be one of the inputs.
+///
+/// They are portable C++, so no particular instruction is guaranteed. For 8-
+/// and 16-bit lanes, Clang can recognize them as the target’s native
+/// saturating instructions (e.g. x86’s `paddusb` and `paddsw`), but GCC (as of
+/// version 12) emits sequences that widen, clamp, and pack, which are correct
+/// but slower. For wider lanes, both emit compare-and-blend sequences.
+///
+/// ### `clamping_cast`
+///
+/// Computes `result[i] = clamping_cast<R>(value[i])`, e.g. to narrow `int32_t`
+/// accumulators to `int16_t` or `uint8_t` for export. You must give both `R`
+/// and `T` when passing containers. `result` must not overlap `value`.
+template <typename R, typename T>
+void clamping_cast(span<const T> value, span<R> result) {
+  assert_is_integral(R);
+  assert_is_integral(T);
+  if (value.size() < result.size()) {
+    trap();
+  }
+  for (size_t i = 0; i < result.size(); i++) {
+    result[i] = clamping_cast<R>(value[i]);
+  }
+}
+
+/// ### `clamping_add`
+///
+/// Computes `result[i] = x[i] + y[i]`.
+template <typename T>
+void clamping_add(span<const T> x, span<const T> y, span<T> result) {
+  assert_is_integral(T);
+  internal::batch_map(x, y, result, internal::batch_clamping_add<T>{});
+}
+
+/// ### `clamping_add`
+///
+/// Computes `result[i] = x[i] + y`.
+template <typename T>
+void clamping_add(span<const T> x, T y, span<T> result) {
+  assert_is_integral(T);
+  internal::batch_map(x, y, result, internal::batch_clamping_add<T>{});
+}
+
+/// ### `clamping_sub`
+///
+/// Computes `result[i] = x[i] - y[i]`.
+template <typename T>
+void clamping_sub(span<const T> x, span<const T> y, span<T> result) {
+  assert_is_integral(T);
+  internal::batch_map(x, y, result, internal::batch_clamping_sub<T>{});
+}
+
+/// ### `clamping_sub`
+///
+/// Computes `result[i] = x[i] - y`.
+template <typename T>
+void clamping_sub(span<const T> x, T y, span<T> result) {
+  assert_is_integral(T);
+  internal::batch_map(x, y, result, internal::batch_clamping_sub<T>{});
+}
+
+/// ### `clamping_sub`
+///
+/// Computes `result[i] = x - y[i]`.
+template <typename T>
+void clamping_sub(T x, span<const T> y, span<T> result) {
+  assert_is_integral(T);
+  internal::batch_map(x, y, result, internal::batch_clamping_sub<T>{});
+}
+
+/// ### `clamping_mul`
+///
+/// Computes `result[i] = x[i] * y[i]`.
+template <typename T>
+void clamping_mul(span<const T> x, span<const T> y, span<T> result) {
+  assert_is_integral(T);
+  internal::batch_map(x, y, result, internal::batch_clamping_mul<T>{});
+}
+
+/// ### `clamping_mul`
+///
+/// Computes `result[i] = x[i] * y`.
+template <typename T>
+void clamping_mul(span<const T> x, T y, span<T> result) {
+  assert_is_integral(T);
+  internal::batch_map(x, y, result, internal::batch_clamping_mul<T>{});
+}
+
+/// ### `clamping_mul_high`
+///
+/// Computes `result[i] = clamping_mul_high(x[i], y[i])`.
+template <typename T>
+void clamping_mul_high(span<const T> x, span<const T> y, span<T> result) {
+  assert_is_integral(T);
+  internal::batch_map(x, y, result, internal::batch_clamping_mul_high<T>{});
+}
+
+/// ### `clamping_mul_high`
+///
+/// Computes `result[i] = clamping_mul_high(x[i], y)`, e.g. to scale samples
+/// by a constant gain.
+template <typename T>
+void clamping_mul_high(span<const T> x, T y, span<T> result) {
+  assert_is_integral(T);
+  internal::batch_map(x, y, result, internal::batch_clamping_mul_high<T>{});
+}
+
+/// ### `clamping_average`
+///
+/// Computes `result[i] = clamping_average(x[i], y[i])`.
+template <typename T>
+void clamping_average(span<const T> x, span<const T> y, span<T> result) {
+  assert_is_integral(T);
+  internal::batch_map(x, y, result, internal::batch_clamping_average<T>{});
+}
+
+}  // namespace integers
+
+#endif  // BATCH_H_
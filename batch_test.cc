@@ -0,0 +1,398 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "batch.h"
+#include "test_support.h"
+
+using namespace integers;
+using namespace std;
+
+namespace {
+
+using i8 = int8_t;
+using u8 = uint8_t;
+using i16 = int16_t;
+using u16 = uint16_t;
+using i32 = int32_t;
+using u32 = uint32_t;
+using i64 = int64_t;
+using u64 = uint64_t;
+
+// Spans several chunks, and does not end on a chunk boundary.
+constexpr size_t kCount = 2500;
+
+template <typename T>
+vector<T> Iota(size_t count, T modulus) {
+  vector<T> v(count);
+  for (size_t i = 0; i < count; i++) {
+    v[i] = static_cast<T>(i % static_cast<size_t>(modulus));
+  }
+  return v;
+}
+
+template <typename T>
+void GenericTestBatch() {
+  const auto a = Iota<T>(kCount, 10);
+  const auto b = Iota<T>(kCount, 7);
+  vector<T> r(kCount);
+
+  trapping_add<T>(a, b, r);
+  for (size_t i = 0; i < kCount; i++) {
+    EXPECT(r[i] == a[i] + b[i]);
+  }
+  const vector<T> sum = r;
+  trapping_add<T>(a, T{3}, r);
+  for (size_t i = 0; i < kCount; i++) {
+    EXPECT(r[i] == a[i] + 3);
+  }
+
+  trapping_sub<T>(sum, b, r);
+  EXPECT(r == a);
+  trapping_sub<T>(a, T{0}, r);
+  EXPECT(r == a);
+  trapping_sub<T>(T{9}, a, r);
+  for (size_t i = 0; i < kCount; i++) {
+    EXPECT(r[i] == 9 - a[i]);
+  }
+
+  trapping_mul<T>(a, b, r);
+  for (size_t i = 0; i < kCount; i++) {
+    EXPECT(r[i] == a[i] * b[i]);
+  }
+  trapping_mul<T>(a, T{2}, r);
+  for (size_t i = 0; i < kCount; i++) {
+    EXPECT(r[i] == a[i] * 2);
+  }
+
+  // In place.
+  vector<T> c = a;
+  trapping_add<T>(c, b, c);
+  for (size_t i = 0; i < kCount; i++) {
+    EXPECT(c[i] == a[i] + b[i]);
+  }
+
+  // Empty.
+  trapping_add<T>(span<const T>(), span<const T>(), span<T>());
+
+  const T max = numeric_limits<T>::max();
+  const T min = numeric_limits<T>::min();
+  EXPECT_DEATH(trapping_add<T>(a, max, r));
+  EXPECT_DEATH(trapping_sub<T>(min, b, r));
+  EXPECT_DEATH(trapping_mul<T>(a, max, r));
+
+  // `x` is too short.
+  EXPECT_DEATH(trapping_add<T>(span<const T>(a).first(kCount - 1), b, r));
+}
+
+template <class... T>
+void CallGenericTestBatch() {
+  (GenericTestBatch<T>(), ...);
+}
+
+void TestBatch() {
+  CallGenericTestBatch<i8, u8, i16, u16, i32, u32, i64, u64>();
+}
+
+void TestFirstOverflow() {
+  vector<i32> a(kCount, 1);
+  vector<i32> r(kCount, -1);
+  constexpr size_t bad = 1500;
+  a[bad] = numeric_limits<i32>::max();
+
+  // Elements before the first overflow are written; the rest are not.
+  const size_t first = internal::batch_until_overflow(
+      span<const i32>(a), i32{1}, span<i32>(r), internal::batch_add<i32>{});
+  EXPECT(first == bad);
+  for (size_t i = 0; i < bad; i++) {
+    EXPECT(r[i] == 2);
+  }
+  for (size_t i = bad; i < kCount; i++) {
+    EXPECT(r[i] == -1);
+  }
+
+  // In place.
+  const size_t in_place = internal::batch_until_overflow(
+      span<const i32>(a), i32{1}, span<i32>(a), internal::batch_add<i32>{});
+  EXPECT(in_place == bad);
+  EXPECT(a[bad - 1] == 2);
+  EXPECT(a[bad] == numeric_limits<i32>::max());
+  EXPECT(a[bad + 1] == 1);
+}
+
+bool IsSet(const vector<u64>& mask, size_t i) {
+  return (mask[i / 64] >> (i % 64)) & 1;
+}
+
+template <typename T>
+void GenericTestOverflowMask() {
+  const T max = numeric_limits<T>::max();
+  auto a = Iota<T>(kCount, 10);
+  const auto b = Iota<T>(kCount, 7);
+  vector<T> r(kCount);
+  vector<u64> mask(overflow_mask_size(kCount), ~u64{0});
+
+  EXPECT(!add_overflow<T>(a, b, r, mask));
+  for (size_t i = 0; i < kCount; i++) {
+    EXPECT(!IsSet(mask, i));
+    EXPECT(r[i] == a[i] + b[i]);
+  }
+  EXPECT(find_first_overflow(mask, kCount) == kCount);
+  EXPECT(find_last_overflow(mask, kCount) == kCount);
+
+  a[3] = max;
+  a[700] = max;
+  a[kCount - 2] = max;
+  EXPECT(add_overflow<T>(a, b, r, mask));
+  for (size_t i = 0; i < kCount; i++) {
+    EXPECT(IsSet(mask, i) == (a[i] == max && b[i] != 0));
+  }
+  EXPECT(find_first_overflow(mask, kCount) == 3);
+  EXPECT(find_last_overflow(mask, kCount) == kCount - 2);
+  // Every result is written, wrapping on overflow.
+  EXPECT(r[3] == static_cast<T>(numeric_limits<T>::min() + T{2}));
+
+  EXPECT(add_overflow<T>(a, T{1}, r, mask));
+  EXPECT(find_first_overflow(mask, kCount) == 3);
+  EXPECT(find_last_overflow(mask, kCount) == kCount - 2);
+
+  EXPECT(mul_overflow<T>(a, b, r, mask));
+  EXPECT(find_first_overflow(mask, kCount) == 3);
+  EXPECT(!mul_overflow<T>(a, T{1}, r, mask));
+  EXPECT(r == a);
+
+  const T min = numeric_limits<T>::min();
+  EXPECT(sub_overflow<T>(min, b, r, mask));
+  EXPECT(find_first_overflow(mask, kCount) == 1);
+  EXPECT(!sub_overflow<T>(a, T{0}, r, mask));
+  EXPECT(r == a);
+
+  // Casts to a narrower type, and between signednesses.
+  vector<i8> narrow(kCount);
+  const bool narrowed = !is_same_v<T, i8>;
+  EXPECT((cast_truncate<i8, T>(a, narrow, mask)) == narrowed);
+  for (size_t i = 0; i < kCount; i++) {
+    EXPECT(IsSet(mask, i) == !integers::in_range<i8>(a[i]));
+    EXPECT(narrow[i] == static_cast<i8>(a[i]));
+  }
+  vector<T> negative(kCount, static_cast<T>(-1));
+  vector<u64> wide(kCount);
+  const bool negated = is_signed_v<T>;
+  EXPECT((cast_truncate<u64, T>(negative, wide, mask)) == negated);
+
+  // Single overflows land on their own bits of the mask words.
+  for (const size_t at : {size_t{1}, size_t{62}}) {
+    vector<T> one(64, T{0});
+    one[at] = max;
+    vector<T> sum(64);
+    vector<u64> bits(1);
+    EXPECT(add_overflow<T>(one, T{1}, sum, bits));
+    EXPECT(u64{1} << at == bits[0]);
+  }
+
+  // The mask is too short.
+  EXPECT_DEATH(static_cast<void>(add_overflow<T>(
+      a, b, r, span<u64>(mask).first(overflow_mask_size(kCount) - 1))));
+}
+
+template <class... T>
+void CallGenericTestOverflowMask() {
+  (GenericTestOverflowMask<T>(), ...);
+}
+
+void TestOverflowMask() {
+  CallGenericTestOverflowMask<i8, u8, i16, u16, i32, u32, i64, u64>();
+}
+
+void TestFindOverflow() {
+  EXPECT(overflow_mask_size(0) == 0);
+  EXPECT(overflow_mask_size(1) == 1);
+  EXPECT(overflow_mask_size(64) == 1);
+  EXPECT(overflow_mask_size(65) == 2);
+
+  const vector<u64> mask = {0, u64{1} << 63, 0x10};
+  EXPECT(find_first_overflow(mask, 192) == 127);
+  EXPECT(find_last_overflow(mask, 192) == 132);
+  // Bits past `count` are ignored.
+  EXPECT(find_last_overflow(mask, 132) == 127);
+  EXPECT(find_first_overflow(mask, 100) == 100);
+  EXPECT(find_last_overflow(mask, 100) == 100);
+  EXPECT(find_first_overflow(span<const u64>(), 0) == 0);
+}
+
+template <typename R, typename T>
+void TestBatchCastPair() {
+  constexpr T t_max = numeric_limits<T>::max();
+  constexpr T t_min = numeric_limits<T>::min();
+  constexpr R r_max = numeric_limits<R>::max();
+  vector<T> v = Iota<T>(kCount, 100);
+  vector<R> r(kCount);
+
+  EXPECT((all_in_range<R, T>(v)));
+  EXPECT((all_in_range<R, T>(span<const T>())));
+  trapping_cast<R, T>(v, r);
+  for (size_t i = 0; i < kCount; i++) {
+    EXPECT(r[i] == static_cast<R>(v[i]));
+  }
+
+  const bool max_fits = integers::in_range<R>(t_max);
+  const bool min_fits = integers::in_range<R>(t_min);
+  v[1234] = t_max;
+  EXPECT((all_in_range<R, T>(v)) == max_fits);
+  if (!max_fits) {
+    EXPECT_DEATH((trapping_cast<R, T>(v, r)));
+  }
+  v[1234] = t_min;
+  EXPECT((all_in_range<R, T>(v)) == min_fits);
+  if (!min_fits) {
+    EXPECT_DEATH((trapping_cast<R, T>(v, r)));
+  }
+  // Just in range, at the edge.
+  if (!max_fits) {
+    v[1234] = static_cast<T>(r_max);
+    EXPECT((all_in_range<R, T>(v)));
+    trapping_cast<R, T>(v, r);
+    EXPECT(r[1234] == r_max);
+  }
+
+  EXPECT_DEATH((trapping_cast<R, T>(span<const T>(v).first(kCount - 1), r)));
+}
+
+void TestBatchCast() {
+  TestBatchCastPair<i32, i64>();
+  TestBatchCastPair<u16, i64>();
+  TestBatchCastPair<i8, u8>();
+  TestBatchCastPair<u8, i8>();
+  TestBatchCastPair<i64, i32>();
+  TestBatchCastPair<u64, u32>();
+  TestBatchCastPair<u32, i16>();
+  TestBatchCastPair<i64, u64>();
+}
+
+template <typename R, typename T>
+void TestBatchClampingCastPair() {
+  vector<T> v = Iota<T>(kCount, 100);
+  v[3] = numeric_limits<T>::max();
+  v[4] = numeric_limits<T>::min();
+  vector<R> r(kCount);
+  clamping_cast<R, T>(v, r);
+  for (size_t i = 0; i < kCount; i++) {
+    EXPECT(r[i] == clamping_cast<R>(v[i]));
+  }
+  EXPECT(r[3] == clamping_cast<R>(numeric_limits<T>::max()));
+  EXPECT_DEATH((clamping_cast<R, T>(span<const T>(v).first(kCount - 1), r)));
+}
+
+void TestBatchClampingCast() {
+  TestBatchClampingCastPair<i16, i32>();
+  TestBatchClampingCastPair<u8, i32>();
+  TestBatchClampingCastPair<i32, i64>();
+  TestBatchClampingCastPair<i32, u32>();
+  TestBatchClampingCastPair<u32, i64>();
+  TestBatchClampingCastPair<i8, u64>();
+  TestBatchClampingCastPair<i64, i8>();
+}
+
+template <typename T>
+void GenericTestBatchClamping() {
+  const T max = numeric_limits<T>::max();
+  const T min = numeric_limits<T>::min();
+  vector<T> a = Iota<T>(kCount, 10);
+  vector<T> b = Iota<T>(kCount, 7);
+  a[5] = max;
+  b[6] = max;
+  a[7] = min;
+  vector<T> r(kCount);
+
+  // The span operations agree with the scalar ones, element for element.
+  clamping_add<T>(a, b, r);
+  for (size_t i = 0; i < kCount; i++) {
+    EXPECT(r[i] == (clamping_add<T, T, T>(a[i], b[i])));
+  }
+  EXPECT(r[5] == max);
+  clamping_add<T>(a, max, r);
+  for (size_t i = 0; i < kCount; i++) {
+    EXPECT(r[i] == (clamping_add<T, T, T>(a[i], max)));
+  }
+
+  clamping_sub<T>(a, b, r);
+  for (size_t i = 0; i < kCount; i++) {
+    EXPECT(r[i] == (clamping_sub<T, T, T>(a[i], b[i])));
+  }
+  EXPECT(r[7] == min);
+  clamping_sub<T>(a, T{5}, r);
+  for (size_t i = 0; i < kCount; i++) {
+    EXPECT(r[i] == (clamping_sub<T, T, T>(a[i], T{5})));
+  }
+  clamping_sub<T>(T{5}, a, r);
+  for (size_t i = 0; i < kCount; i++) {
+    EXPECT(r[i] == (clamping_sub<T, T, T>(T{5}, a[i])));
+  }
+
+  clamping_mul<T>(a, b, r);
+  for (size_t i = 0; i < kCount; i++) {
+    EXPECT(r[i] == (clamping_mul<T, T, T>(a[i], b[i])));
+  }
+  clamping_mul<T>(a, max, r);
+  for (size_t i = 0; i < kCount; i++) {
+    EXPECT(r[i] == (clamping_mul<T, T, T>(a[i], max)));
+  }
+
+  clamping_mul_high<T>(a, b, r);
+  for (size_t i = 0; i < kCount; i++) {
+    EXPECT(r[i] == clamping_mul_high<T>(a[i], b[i]));
+  }
+  clamping_mul_high<T>(a, max, r);
+  for (size_t i = 0; i < kCount; i++) {
+    EXPECT(r[i] == clamping_mul_high<T>(a[i], max));
+  }
+
+  clamping_average<T>(a, b, r);
+  for (size_t i = 0; i < kCount; i++) {
+    EXPECT(r[i] == clamping_average<T>(a[i], b[i]));
+  }
+
+  // In place.
+  vector<T> c = a;
+  clamping_add<T>(c, b, c);
+  for (size_t i = 0; i < kCount; i++) {
+    EXPECT(c[i] == (clamping_add<T, T, T>(a[i], b[i])));
+  }
+
+  EXPECT_DEATH(clamping_add<T>(span<const T>(a).first(kCount - 1), b, r));
+}
+
+template <class... T>
+void CallGenericTestBatchClamping() {
+  (GenericTestBatchClamping<T>(), ...);
+}
+
+void TestBatchClamping() {
+  CallGenericTestBatchClamping<i8, u8, i16, u16, i32, u32, i64, u64>();
+}
+
+}  // namespace
+
+int main() {
+  TestBatch();
+  TestFirstOverflow();
+  TestOverflowMask();
+  TestFindOverflow();
+  TestBatchClamping();
+  TestBatchCast();
+  TestBatchClampingCast();
+}
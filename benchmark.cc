@@ -0,0 +1,839 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Rough timings of the library’s types and functions against plain integer
+// code doing the same work. Build and run with `make benchmark`.
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "batch.h"
+#include "byte_order.h"
+#include "charconv.h"
+#include "checked.h"
+#include "checksum.h"
+#include "delta.h"
+#include "parallel.h"
+#include "ranged.h"
+#include "reduce.h"
+#include "requantize.h"
+#include "serial.h"
+#include "simd.h"
+#include "summed_area.h"
+#include "trapping.h"
+#include "varint.h"
+
+using namespace integers;
+
+namespace {
+
+constexpr size_t kCount = 1 << 20;
+constexpr int kRepetitions = 20;
+
+// Keeps the compiler from optimizing away the computation of `value`.
+template <typename T>
+void Consume(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Runs `f` `kRepetitions` times and prints the best time, and the throughput
+// given that `f` reads and writes `bytes` bytes.
+template <typename F>
+void Run(const char* name, size_t bytes, F f) {
+  using Clock = std::chrono::steady_clock;
+  double best = 1e30;
+  for (int i = 0; i < kRepetitions; i++) {
+    const auto start = Clock::now();
+    f();
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+    best = std::min(best, elapsed.count());
+  }
+  std::cout << std::left << std::setw(48) << name << std::right << std::fixed
+            << std::setprecision(3) << std::setw(10) << best * 1e3 << " ms"
+            << std::setw(10) << static_cast<double>(bytes) / best / 1e9
+            << " GB/s\n";
+}
+
+template <typename T>
+std::vector<T> MakeInput(size_t count, T modulus) {
+  std::vector<T> v(count);
+  uint64_t state = 0x9E3779B97F4A7C15u;
+  for (auto& x : v) {
+    state = state * 6364136223846793005u + 1442695040888963407u;
+    x = static_cast<T>(static_cast<T>(state >> 33) % modulus);
+  }
+  return v;
+}
+
+// Dot products of two `int32_t` arrays, accumulating in `int64_t`. (The
+// products of `int32_t`s cannot overflow `int64_t`, but the sum can.)
+void BenchmarkDot() {
+  const auto a = MakeInput<int32_t>(kCount, 1 << 20);
+  const auto b = MakeInput<int32_t>(kCount, 1 << 20);
+  const size_t bytes = 2 * kCount * sizeof(int32_t);
+
+  Run("dot: int64_t", bytes, [&] {
+    int64_t sum = 0;
+    for (size_t i = 0; i < kCount; i++) {
+      sum += int64_t{a[i]} * b[i];
+    }
+    Consume(sum);
+  });
+
+  Run("dot: trapping<int64_t>", bytes, [&] {
+    trapping<int64_t> sum{int64_t{0}};
+    for (size_t i = 0; i < kCount; i++) {
+      sum += int64_t{a[i]} * b[i];
+    }
+    Consume(sum);
+  });
+
+  Run("dot: checked<int64_t>", bytes, [&] {
+    checked<int64_t> sum{int64_t{0}};
+    for (size_t i = 0; i < kCount; i++) {
+      sum += int64_t{a[i]} * b[i];
+    }
+    Consume(sum.value_or_trap());
+  });
+
+  Run("dot: checked_dot<int64_t>", bytes, [&] {
+    Consume(checked_dot<int64_t, int32_t>(a, b));
+  });
+}
+
+// Sums of an `int32_t` array: with `std::accumulate` over `trapping<int64_t>`
+// and with `checked_sum`.
+void BenchmarkSum() {
+  const auto a =
+      MakeInput<int32_t>(kCount, std::numeric_limits<int32_t>::max());
+  const size_t bytes = kCount * sizeof(int32_t);
+
+  Run("sum: std::accumulate trapping<int64_t>", bytes, [&] {
+    Consume(std::accumulate(a.begin(), a.end(), trapping<int64_t>{int64_t{0}},
+                            [](trapping<int64_t> sum, int32_t x) {
+                              return sum + int64_t{x};
+                            }));
+  });
+
+  Run("sum: checked_sum<int64_t>", bytes,
+      [&] { Consume(checked_sum<int64_t, int32_t>(a)); });
+}
+
+// Element-wise `out[i] = a[i] * b[i] + c` on `int32_t` arrays.
+void BenchmarkMultiplyAdd() {
+  const auto a = MakeInput<int32_t>(kCount, 1 << 15);
+  const auto b = MakeInput<int32_t>(kCount, 1 << 15);
+  std::vector<int32_t> out(kCount);
+  const size_t bytes = 3 * kCount * sizeof(int32_t);
+  constexpr int32_t c = 12345;
+
+  Run("multiply-add: int32_t", bytes, [&] {
+    for (size_t i = 0; i < kCount; i++) {
+      out[i] = a[i] * b[i] + c;
+    }
+    Consume(out[kCount - 1]);
+  });
+
+  Run("multiply-add: trapping<int32_t>", bytes, [&] {
+    for (size_t i = 0; i < kCount; i++) {
+      out[i] = trapping<int32_t>{a[i]} * b[i] + c;
+    }
+    Consume(out[kCount - 1]);
+  });
+
+  Run("multiply-add: checked<int32_t>", bytes, [&] {
+    int32_t invalid = 0;
+    for (size_t i = 0; i < kCount; i++) {
+      const checked<int32_t> r = checked<int32_t>{a[i]} * b[i] + c;
+      invalid |= !r.is_valid();
+      out[i] = r.value_or(0);
+    }
+    if (invalid) {
+      trap();
+    }
+    Consume(out[kCount - 1]);
+  });
+
+  using Vector = trapping_simd<int32_t, 8>;
+  Run("multiply-add: trapping_simd<int32_t, 8>", bytes, [&] {
+    for (size_t i = 0; i < kCount; i += Vector::size()) {
+      (Vector::load(&a[i]) * Vector::load(&b[i]) + c).store(&out[i]);
+    }
+    Consume(out[kCount - 1]);
+  });
+}
+
+// Element-wise `out[i] = a[i] + b[i]` on arrays of `T`, as a plain loop, with
+// the batch `trapping_add`, and with the batch `add_overflow` (which also
+// writes an overflow mask).
+template <typename T>
+void BenchmarkBatchAdd(const char* type) {
+  const auto a = MakeInput<T>(kCount, std::numeric_limits<T>::max() / 2);
+  const auto b = MakeInput<T>(kCount, std::numeric_limits<T>::max() / 2);
+  std::vector<T> out(kCount);
+  const size_t bytes = 3 * kCount * sizeof(T);
+
+  Run(("batch add: " + std::string(type)).c_str(), bytes, [&] {
+    for (size_t i = 0; i < kCount; i++) {
+      out[i] = static_cast<T>(a[i] + b[i]);
+    }
+    Consume(out[kCount - 1]);
+  });
+
+  Run(("batch add: trapping_add<" + std::string(type) + ">").c_str(), bytes,
+      [&] {
+        trapping_add<T>(a, b, out);
+        Consume(out[kCount - 1]);
+      });
+
+  std::vector<uint64_t> mask(overflow_mask_size(kCount));
+  Run(("batch add: add_overflow<" + std::string(type) + ">").c_str(), bytes,
+      [&] {
+        Consume(add_overflow<T>(a, b, out, mask));
+        Consume(out[kCount - 1]);
+      });
+}
+
+// Narrowing `int64_t` to `R`, as a plain loop, with a loop of the scalar
+// `trapping_cast`, and with the batch `trapping_cast`.
+template <typename R>
+void BenchmarkNarrow(const char* type) {
+  const auto a = MakeInput<int64_t>(kCount, std::numeric_limits<R>::max());
+  std::vector<R> out(kCount);
+  const size_t bytes = kCount * (sizeof(int64_t) + sizeof(R));
+
+  Run(("narrow: static_cast<" + std::string(type) + ">").c_str(), bytes, [&] {
+    for (size_t i = 0; i < kCount; i++) {
+      out[i] = static_cast<R>(a[i]);
+    }
+    Consume(out[kCount - 1]);
+  });
+
+  Run(("narrow: trapping_cast<" + std::string(type) + ">").c_str(), bytes, [&] {
+    for (size_t i = 0; i < kCount; i++) {
+      out[i] = trapping_cast<R>(a[i]);
+    }
+    Consume(out[kCount - 1]);
+  });
+
+  Run(("narrow: batch trapping_cast<" + std::string(type) + ">").c_str(),
+      bytes, [&] {
+        trapping_cast<R, int64_t>(a, out);
+        Consume(out[kCount - 1]);
+      });
+}
+
+// Saturating narrowing of `T` to `R`, with `std::clamp` and with the batch
+// `clamping_cast`.
+template <typename R, typename T>
+void BenchmarkClampingNarrow(const char* name) {
+  const auto a = MakeInput<T>(kCount, std::numeric_limits<T>::max());
+  std::vector<R> out(kCount);
+  const size_t bytes = kCount * (sizeof(T) + sizeof(R));
+
+  Run(("narrow: std::clamp " + std::string(name)).c_str(), bytes,
+      [&] {
+        for (size_t i = 0; i < kCount; i++) {
+          out[i] = static_cast<R>(
+              std::clamp<T>(a[i], std::numeric_limits<R>::min(),
+                            std::numeric_limits<R>::max()));
+        }
+        Consume(out[kCount - 1]);
+      });
+
+  Run(("narrow: clamping_cast " + std::string(name)).c_str(), bytes,
+      [&] {
+        clamping_cast<R, T>(a, out);
+        Consume(out[kCount - 1]);
+      });
+}
+
+// Element-wise saturating `out[i] = a[i] + b[i]` and `out[i] = a[i] - b[i]` on
+// arrays of `T`, with a scalar `clamping<T>` loop and with the batch
+// `clamping_add` and `clamping_sub`.
+template <typename T>
+void BenchmarkClamping(const char* type) {
+  const auto a = MakeInput<T>(kCount, std::numeric_limits<T>::max());
+  const auto b = MakeInput<T>(kCount, std::numeric_limits<T>::max() / 2);
+  std::vector<T> out(kCount);
+  const size_t bytes = 3 * kCount * sizeof(T);
+
+  Run(("clamping add: clamping<" + std::string(type) + ">").c_str(), bytes,
+      [&] {
+        for (size_t i = 0; i < kCount; i++) {
+          out[i] = clamping<T>{a[i]} + clamping<T>{b[i]};
+        }
+        Consume(out[kCount - 1]);
+      });
+
+  Run(("clamping add: clamping_add<" + std::string(type) + ">").c_str(), bytes,
+      [&] {
+        clamping_add<T>(a, b, out);
+        Consume(out[kCount - 1]);
+      });
+
+  Run(("clamping sub: clamping<" + std::string(type) + ">").c_str(), bytes,
+      [&] {
+        for (size_t i = 0; i < kCount; i++) {
+          out[i] = clamping<T>{a[i]} - clamping<T>{b[i]};
+        }
+        Consume(out[kCount - 1]);
+      });
+
+  Run(("clamping sub: clamping_sub<" + std::string(type) + ">").c_str(), bytes,
+      [&] {
+        clamping_sub<T>(a, b, out);
+        Consume(out[kCount - 1]);
+      });
+}
+
+}  // namespace
+
+// Offset tables from record sizes, with a loop of `trapping<uint32_t>`
+// additions and with the checked scans.
+void BenchmarkOffsets() {
+  const auto sizes = MakeInput<uint32_t>(kCount, 1000);
+  std::vector<uint32_t> offsets(kCount + 1);
+  const size_t bytes = 2 * kCount * sizeof(uint32_t);
+
+  Run("offsets: loop of trapping<uint32_t>", bytes, [&] {
+    trapping<uint32_t> offset{0u};
+    offsets[0] = 0;
+    for (size_t i = 0; i < kCount; i++) {
+      offset += sizes[i];
+      offsets[i + 1] = static_cast<uint32_t>(offset);
+    }
+    Consume(offsets[kCount]);
+  });
+
+  Run("offsets: checked_exclusive_scan<uint32_t>", bytes, [&] {
+    Consume(checked_exclusive_scan<uint32_t, uint32_t>(sizes, offsets));
+  });
+
+  std::vector<uint64_t> wide_offsets(kCount + 1);
+  Run("offsets: checked_exclusive_scan<uint64_t>", bytes, [&] {
+    Consume(checked_exclusive_scan<uint64_t, uint32_t>(sizes, wide_offsets));
+  });
+}
+
+// Summed-area tables of a 4K frame, with a `trapping<uint32_t>` addition per
+// entry, and unchecked in `uint64_t` and (proven wide enough) `uint32_t`.
+void BenchmarkSummedArea() {
+  constexpr size_t kWidth = 3840;
+  constexpr size_t kHeight = 2160;
+  const auto frame = MakeInput<uint8_t>(kWidth * kHeight, 255);
+
+  std::vector<uint32_t> table(kWidth * kHeight);
+  Run("summed area: trapping<uint32_t>",
+      kWidth * kHeight * (1 + sizeof(uint32_t)), [&] {
+        for (size_t y = 0; y < kHeight; y++) {
+          trapping<uint32_t> row{0u};
+          for (size_t x = 0; x < kWidth; x++) {
+            row += frame[y * kWidth + x];
+            table[y * kWidth + x] = static_cast<uint32_t>(
+                y == 0 ? row : row + table[(y - 1) * kWidth + x]);
+          }
+        }
+        Consume(table.back());
+      });
+
+  std::vector<uint64_t> wide_table(kWidth * kHeight);
+  Run("summed area: summed_area_table<uint64_t>",
+      kWidth * kHeight * (1 + sizeof(uint64_t)), [&] {
+        summed_area_table<uint64_t, uint8_t>(frame, kWidth, kHeight,
+                                             wide_table);
+        Consume(wide_table.back());
+      });
+
+  Run("summed area: summed_area_table<uint32_t>",
+      kWidth * kHeight * (1 + sizeof(uint32_t)), [&] {
+        summed_area_table<uint32_t, uint8_t>(frame, kWidth, kHeight, table);
+        Consume(table.back());
+      });
+}
+
+// Scaling of the parallel functions from 1 thread to one per hardware thread,
+// over spans much bigger than the last-level cache.
+void BenchmarkParallel() {
+  constexpr size_t kLargeCount = size_t{1} << 24;
+  const auto a = MakeInput<int64_t>(kLargeCount, int64_t{1} << 40);
+  const auto b = MakeInput<int64_t>(kLargeCount, int64_t{1} << 40);
+  std::vector<int64_t> out(kLargeCount);
+  const size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+
+  for (size_t threads = 1;; threads = std::min(2 * threads, hardware)) {
+    const std::string suffix = ", " + std::to_string(threads) + " threads";
+    Run(("parallel: checked_sum<int64_t>" + suffix).c_str(),
+        kLargeCount * sizeof(int64_t), [&] {
+          Consume(parallel_checked_sum<int64_t, int64_t>(a, threads));
+        });
+    Run(("parallel: exclusive_scan<int64_t>" + suffix).c_str(),
+        2 * kLargeCount * sizeof(int64_t), [&] {
+          Consume(parallel_checked_exclusive_scan<int64_t, int64_t>(
+              a, out, threads));
+        });
+    Run(("parallel: trapping_add<int64_t>" + suffix).c_str(),
+        3 * kLargeCount * sizeof(int64_t), [&] {
+          parallel_trapping_add<int64_t>(a, b, out, threads);
+          Consume(out[kLargeCount - 1]);
+        });
+    if (threads == hardware) {
+      break;
+    }
+  }
+}
+
+// Loading wire bytes as `ranged<uint8_t, 0, 11>`, with a constructor (and so
+// a check) per element and with `validate_as`, which checks in bulk and
+// copies nothing.
+void BenchmarkValidate() {
+  using opcode = ranged<uint8_t, 0, 11>;
+  const auto wire = MakeInput<uint8_t>(kCount, 12);
+  std::vector<opcode> opcodes(kCount);
+  const size_t bytes = kCount;
+
+  Run("validate: construct ranged<uint8_t, 0, 11>", bytes, [&] {
+    for (size_t i = 0; i < kCount; i++) {
+      opcodes[i] = wire[i];
+    }
+    Consume(opcodes[kCount - 1]);
+  });
+
+  Run("validate: validate_as<ranged<uint8_t, 0, 11>>", bytes, [&] {
+    Consume(validate_as<opcode>(wire).data());
+  });
+}
+
+// Requantizing `int32_t` accumulators to `int8_t`, with scalar code that
+// branches on the sign to round half away from zero, and with the batch
+// `requantize`.
+void BenchmarkRequantize() {
+  const auto accumulators = MakeInput<int32_t>(kCount, 1 << 20);
+  std::vector<int8_t> out(kCount);
+  const size_t bytes = kCount * (sizeof(int32_t) + sizeof(int8_t));
+  constexpr int32_t kMultiplier = 1518500250;
+  constexpr int kShift = 38;
+  constexpr int32_t kZeroPoint = -3;
+
+  Run("requantize: scalar int8_t", bytes, [&] {
+    for (size_t i = 0; i < kCount; i++) {
+      const int64_t product = int64_t{accumulators[i]} * kMultiplier;
+      const int64_t half = int64_t{1} << (kShift - 1);
+      const int64_t rounded = product >= 0 ? (product + half) >> kShift
+                                           : -((half - product) >> kShift);
+      out[i] = static_cast<int8_t>(
+          std::clamp<int64_t>(rounded + kZeroPoint, -128, 127));
+    }
+    Consume(out[kCount - 1]);
+  });
+
+  Run("requantize: requantize<int8_t>", bytes, [&] {
+    requantize<int8_t>(accumulators, kMultiplier, kShift, kZeroPoint, out);
+    Consume(out[kCount - 1]);
+  });
+}
+
+// Delta coding of `T` timestamps, against a plain copy of the same data, which
+// bounds the throughput of any one-pass kernel.
+template <typename T>
+void BenchmarkDelta(const char* type, size_t count) {
+  std::vector<T> values(count);
+  for (size_t i = 0; i < count; i++) {
+    values[i] = static_cast<T>(1000 * i + i % 7);
+  }
+  std::vector<T> coded(count);
+  std::vector<T> decoded(count);
+  const size_t bytes = 2 * count * sizeof(T);
+  const std::string suffix =
+      std::string(type) + (count > kCount ? ", large" : "");
+
+  Run(("delta: copy " + suffix).c_str(), bytes, [&] {
+    std::copy(values.begin(), values.end(), decoded.begin());
+    Consume(decoded[count - 1]);
+  });
+  Run(("delta: delta_encode " + suffix).c_str(), bytes, [&] {
+    delta_encode<T>(values, coded);
+    Consume(coded[count - 1]);
+  });
+  Run(("delta: delta_decode " + suffix).c_str(), bytes, [&] {
+    delta_decode<T>(coded, decoded);
+    Consume(decoded[count - 1]);
+  });
+  delta_of_delta_encode<T>(values, coded);
+  Run(("delta: delta_of_delta_decode " + suffix).c_str(), bytes, [&] {
+    delta_of_delta_decode<T>(coded, decoded);
+    Consume(decoded[count - 1]);
+  });
+}
+
+// Decoding a stream of varints of 1 to 5 bytes, with a loop over the bytes of
+// each and with the batch `trapping_varint_decode`.
+void BenchmarkVarint() {
+  const auto values = MakeInput<uint32_t>(kCount, UINT32_MAX);
+  std::vector<uint32_t> lengths(kCount);
+  for (size_t i = 0; i < kCount; i++) {
+    lengths[i] = values[i] >> (values[i] % 32);
+  }
+  std::vector<uint8_t> bytes(kCount * max_varint_size<uint32_t>);
+  bytes.resize(varint_encode<uint32_t>(lengths, bytes));
+  std::vector<uint32_t> out(kCount);
+  const size_t size = bytes.size() + kCount * sizeof(uint32_t);
+
+  Run("varint: byte loop uint32_t", size, [&] {
+    size_t offset = 0;
+    for (size_t i = 0; i < kCount; i++) {
+      uint32_t value = 0;
+      for (int shift = 0;; shift += 7) {
+        const uint8_t byte = bytes[offset++];
+        if (shift == 28 && byte > 0x0F) {
+          abort();
+        }
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (byte < 0x80) {
+          break;
+        }
+      }
+      out[i] = value;
+    }
+    Consume(out[kCount - 1]);
+  });
+
+  Run("varint: trapping_varint_decode<uint32_t>", size, [&] {
+    Consume(trapping_varint_decode<uint32_t>(bytes, out));
+  });
+}
+
+void BenchmarkParse() {
+  const auto values = MakeInput<int64_t>(kCount, INT64_MAX);
+  std::string text;
+  for (size_t i = 0; i < kCount; i++) {
+    // A mix of lengths, as in real columns of ids and counts.
+    text += std::to_string((values[i] >> (values[i] % 48)) - 1000);
+    text += '\n';
+  }
+  const char* const first = text.data();
+  const char* const last = first + text.size();
+  std::vector<int64_t> out(kCount);
+
+  Run("parse: strtoll int64_t", text.size(), [&] {
+    const char* p = first;
+    for (size_t i = 0; i < kCount; i++) {
+      char* end;
+      out[i] = strtoll(p, &end, 10);
+      p = end + 1;
+    }
+    Consume(out[kCount - 1]);
+  });
+
+  Run("parse: std::from_chars int64_t", text.size(), [&] {
+    const char* p = first;
+    for (size_t i = 0; i < kCount; i++) {
+      p = std::from_chars(p, last, out[i]).ptr + 1;
+    }
+    Consume(out[kCount - 1]);
+  });
+
+  Run("parse: trapping_from_chars_column<int64_t>", text.size(), [&] {
+    Consume(trapping_from_chars_column<int64_t>(first, last, '\n', out));
+  });
+}
+
+void BenchmarkFormat() {
+  const auto values = MakeInput<int64_t>(kCount, INT64_MAX);
+  std::vector<trapping<int64_t>> numbers(kCount);
+  for (size_t i = 0; i < kCount; i++) {
+    numbers[i] = trapping<int64_t>{(values[i] >> (values[i] % 48)) - 1000};
+  }
+  std::string text(kCount * (max_chars<int64_t> + 1), '\0');
+  const size_t size = to_chars_column(
+      as_underlying(span<const trapping<int64_t>>(numbers)), '\n', text);
+
+  Run("format: std::ostringstream trapping<int64_t>", size, [&] {
+    std::ostringstream stream;
+    for (const trapping<int64_t> x : numbers) {
+      stream << x << '\n';
+    }
+    Consume(stream.tellp());
+  });
+
+  Run("format: to_chars_column trapping<int64_t>", size, [&] {
+    Consume(to_chars_column(
+        as_underlying(span<const trapping<int64_t>>(numbers)), '\n', text));
+  });
+}
+
+void BenchmarkByteOrder() {
+  const auto values = MakeInput<uint32_t>(kCount, UINT32_MAX);
+  std::vector<uint8_t> bytes(kCount * sizeof(uint32_t));
+  store_be<uint32_t>(values, bytes);
+  std::vector<uint32_t> out(kCount);
+  const size_t size = 2 * bytes.size();
+
+  Run("byte order: shift loop uint32_t", size, [&] {
+    for (size_t i = 0; i < kCount; i++) {
+      const uint8_t* p = &bytes[i * 4];
+      out[i] = uint32_t{p[0]} << 24 | uint32_t{p[1]} << 16 |
+               uint32_t{p[2]} << 8 | uint32_t{p[3]};
+    }
+    Consume(out[kCount - 1]);
+  });
+
+  Run("byte order: load_be<uint32_t> per element", size, [&] {
+    for (size_t i = 0; i < kCount; i++) {
+      out[i] = load_be<uint32_t>(bytes, i * sizeof(uint32_t));
+    }
+    Consume(out[kCount - 1]);
+  });
+
+  Run("byte order: load_be<uint32_t> bulk", size, [&] {
+    load_be<uint32_t>(bytes, out);
+    Consume(out[kCount - 1]);
+  });
+}
+
+void BenchmarkTotalLength() {
+  // Hundreds of buffers per call, as for one `writev`.
+  constexpr size_t kBuffers = 512;
+  const auto lengths = MakeInput<size_t>(kBuffers, 1 << 16);
+  std::vector<iovec> buffers(kBuffers);
+  for (size_t i = 0; i < kBuffers; i++) {
+    buffers[i] = iovec{nullptr, lengths[i]};
+  }
+  constexpr size_t kCalls = kCount / kBuffers;
+  const size_t size = kCalls * kBuffers * sizeof(iovec);
+
+  Run("total length: trapping_add loop", size, [&] {
+    for (size_t call = 0; call < kCalls; call++) {
+      size_t total = 0;
+      for (const iovec& buffer : buffers) {
+        total = trapping_add<size_t>(total, buffer.iov_len);
+      }
+      Consume(total);
+    }
+  });
+
+  Run("total length: checked_total_length", size, [&] {
+    for (size_t call = 0; call < kCalls; call++) {
+      Consume(checked_total_length(buffers));
+    }
+  });
+}
+
+constexpr uint64_t kHashPrime1 = 0x9E3779B185EBCA87u;
+constexpr uint64_t kHashPrime2 = 0xC2B2AE3D27D4EB4Fu;
+
+// The xxHash64 round, in `Word` arithmetic.
+template <typename Word>
+Word HashRound(Word accumulator, Word input) {
+  using std::rotl;
+  accumulator += input * Word{kHashPrime2};
+  return rotl(accumulator, 31) * Word{kHashPrime1};
+}
+
+// An xxHash64-style hash of `words`, with `Lanes` independent accumulators
+// that the CPU can overlap.
+template <typename Word, size_t Lanes>
+uint64_t XxHash(const std::vector<uint64_t>& words) {
+  using std::rotl;
+  Word lanes[Lanes];
+  for (size_t lane = 0; lane < Lanes; lane++) {
+    lanes[lane] = Word{kHashPrime1 + lane};
+  }
+  for (size_t i = 0; i + Lanes <= words.size(); i += Lanes) {
+    for (size_t lane = 0; lane < Lanes; lane++) {
+      lanes[lane] = HashRound(lanes[lane], Word{words[i + lane]});
+    }
+  }
+  Word h{uint64_t{0}};
+  for (size_t lane = 0; lane < Lanes; lane++) {
+    h = rotl(h, 7) ^ lanes[lane];
+  }
+  h = (h ^ (h >> 33)) * Word{kHashPrime2};
+  return static_cast<uint64_t>(h ^ (h >> 29));
+}
+
+uint64_t Fold(uint64_t x, uint64_t y) {
+  const unsigned __int128 product = static_cast<unsigned __int128>(x) * y;
+  return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+}
+
+wrapping<uint64_t> Fold(wrapping<uint64_t> x, wrapping<uint64_t> y) {
+  return mul_fold(x, y);
+}
+
+// A wyhash-style hash of `words`: folded multiplies of pairs of words.
+template <typename Word>
+uint64_t WyHash(const std::vector<uint64_t>& words) {
+  Word h{kHashPrime1};
+  for (size_t i = 0; i + 2 <= words.size(); i += 2) {
+    h = Fold(Word{words[i]} ^ Word{kHashPrime2}, Word{words[i + 1]} ^ h);
+  }
+  return static_cast<uint64_t>(Fold(h, Word{kHashPrime1}));
+}
+
+void BenchmarkHash() {
+  const auto words = MakeInput<uint64_t>(kCount, UINT64_MAX);
+  const size_t size = kCount * sizeof(uint64_t);
+  if (XxHash<uint64_t, 1>(words) != XxHash<wrapping<uint64_t>, 1>(words) ||
+      XxHash<uint64_t, 4>(words) != XxHash<wrapping<uint64_t>, 4>(words) ||
+      WyHash<uint64_t>(words) != WyHash<wrapping<uint64_t>>(words)) {
+    abort();
+  }
+
+  Run("hash: xxhash uint64_t", size,
+      [&] { Consume(XxHash<uint64_t, 1>(words)); });
+  Run("hash: xxhash wrapping<uint64_t>", size,
+      [&] { Consume(XxHash<wrapping<uint64_t>, 1>(words)); });
+  Run("hash: xxhash 4 lanes uint64_t", size,
+      [&] { Consume(XxHash<uint64_t, 4>(words)); });
+  Run("hash: xxhash 4 lanes wrapping<uint64_t>", size,
+      [&] { Consume(XxHash<wrapping<uint64_t>, 4>(words)); });
+  Run("hash: wyhash uint64_t", size, [&] { Consume(WyHash<uint64_t>(words)); });
+  Run("hash: wyhash wrapping<uint64_t>", size,
+      [&] { Consume(WyHash<wrapping<uint64_t>>(words)); });
+}
+
+void BenchmarkChecksum() {
+  const auto bytes = MakeInput<uint8_t>(4 * kCount, 255);
+  const size_t size = bytes.size();
+
+  Run("checksum: one's complement word loop", size, [&] {
+    uint64_t sum = 0;
+    for (size_t i = 0; i + 1 < bytes.size(); i += 2) {
+      sum += uint32_t{bytes[i]} << 8 | bytes[i + 1];
+    }
+    while (sum > 0xFFFF) {
+      sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    Consume(sum);
+  });
+
+  Run("checksum: internet_checksum", size,
+      [&] { Consume(internet_checksum(bytes)); });
+
+  // zlib's scalar loop: a modulo every 5552 bytes, a running sum per byte.
+  Run("checksum: adler32 running sums", size, [&] {
+    uint32_t a = 1;
+    uint32_t b = 0;
+    for (size_t start = 0; start < bytes.size(); start += 5552) {
+      const size_t end = std::min(bytes.size(), start + 5552);
+      for (size_t i = start; i < end; i++) {
+        a += bytes[i];
+        b += a;
+      }
+      a %= 65521;
+      b %= 65521;
+    }
+    Consume((b << 16) | a);
+  });
+
+  Run("checksum: adler32", size, [&] { Consume(adler32(bytes)); });
+  Run("checksum: fletcher16", size, [&] { Consume(fletcher16(bytes)); });
+}
+
+// Checks a batch of acknowledgments against a send window that wraps.
+void BenchmarkSerial() {
+  const auto acks =
+      MakeInput<uint32_t>(kCount, std::numeric_limits<uint32_t>::max());
+  const uint32_t low = 0xFFFF0000u;
+  const uint32_t width = 0x40000000u;
+  static bool branchy[kCount];
+  static bool valid[kCount];
+  const size_t size = acks.size() * sizeof(uint32_t);
+
+  // The usual sequence number comparisons, `low <= ack < low + width`.
+  Run("serial: signed comparisons", size, [&] {
+    const uint32_t high = low + width;
+    size_t count = 0;
+    for (size_t i = 0; i < acks.size(); i++) {
+      const bool inside = static_cast<int32_t>(acks[i] - low) >= 0 &&
+                          static_cast<int32_t>(acks[i] - high) < 0;
+      branchy[i] = inside;
+      count += inside;
+    }
+    Consume(count);
+  });
+
+  // The RFC 1982 comparisons, which short-circuit.
+  Run("serial: operator<= and operator<", size, [&] {
+    const serial<uint32_t> start{low};
+    const serial<uint32_t> end = start + width;
+    size_t count = 0;
+    for (size_t i = 0; i < acks.size(); i++) {
+      const serial<uint32_t> ack{acks[i]};
+      const bool inside = start <= ack && ack < end;
+      branchy[i] = inside;
+      count += inside;
+    }
+    Consume(count);
+  });
+
+  Run("serial: in_window", size, [&] {
+    Consume(in_window(as_serial<const uint32_t>(acks), serial<uint32_t>{low},
+                      width, valid));
+  });
+}
+
+int main() {
+  BenchmarkDot();
+  BenchmarkSum();
+  BenchmarkMultiplyAdd();
+  BenchmarkBatchAdd<int8_t>("int8_t");
+  BenchmarkBatchAdd<uint8_t>("uint8_t");
+  BenchmarkBatchAdd<int16_t>("int16_t");
+  BenchmarkBatchAdd<uint16_t>("uint16_t");
+  BenchmarkBatchAdd<int32_t>("int32_t");
+  BenchmarkBatchAdd<uint32_t>("uint32_t");
+  BenchmarkBatchAdd<int64_t>("int64_t");
+  BenchmarkBatchAdd<uint64_t>("uint64_t");
+  BenchmarkNarrow<int32_t>("int32_t");
+  BenchmarkNarrow<uint16_t>("uint16_t");
+  BenchmarkClampingNarrow<int16_t, int32_t>("int32_t -> int16_t");
+  BenchmarkClampingNarrow<uint8_t, int32_t>("int32_t -> uint8_t");
+  BenchmarkClampingNarrow<int32_t, int64_t>("int64_t -> int32_t");
+  BenchmarkClamping<uint8_t>("uint8_t");
+  BenchmarkClamping<int16_t>("int16_t");
+  BenchmarkClamping<int32_t>("int32_t");
+  BenchmarkClamping<uint64_t>("uint64_t");
+  BenchmarkOffsets();
+  BenchmarkSummedArea();
+  BenchmarkParallel();
+  BenchmarkValidate();
+  BenchmarkRequantize();
+  BenchmarkDelta<uint32_t>("uint32_t", kCount);
+  BenchmarkDelta<uint64_t>("uint64_t", kCount);
+  BenchmarkDelta<uint32_t>("uint32_t", 64 * kCount);
+  BenchmarkDelta<uint64_t>("uint64_t", 32 * kCount);
+  BenchmarkVarint();
+  BenchmarkParse();
+  BenchmarkFormat();
+  BenchmarkByteOrder();
+  BenchmarkTotalLength();
+  BenchmarkHash();
+  BenchmarkChecksum();
+  BenchmarkSerial();
+}
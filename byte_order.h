@@ -0,0 +1,285 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BYTE_ORDER_H_
+#define BYTE_ORDER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <type_traits>
+#include <utility>
+
+#include "clamping.h"
+#include "is_integral.h"
+#include "ranged.h"
+#include "span.h"
+#include "trap.h"
+#include "trapping.h"
+#include "wrapping.h"
+
+#if !__has_builtin(__builtin_shufflevector)
+#error byte_order.h needs the vector extensions of GCC or Clang.
+#endif
+
+namespace internal {
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+constexpr bool kLittleEndian = false;
+#else
+constexpr bool kLittleEndian = true;
+#endif
+
+// The integer type that a field of type `R` holds: `R` itself, or the `T` of
+// a policy type.
+template <typename R>
+struct field_traits {
+  using value_type = R;
+};
+
+template <typename T>
+struct field_traits<integers::trapping<T>> {
+  using value_type = T;
+};
+
+template <typename T>
+struct field_traits<integers::clamping<T>> {
+  using value_type = T;
+};
+
+template <typename T>
+struct field_traits<integers::wrapping<T>> {
+  using value_type = T;
+};
+
+template <typename T, T Min, T Max>
+struct field_traits<integers::ranged<T, Min, Max>> {
+  using value_type = T;
+};
+
+// `trap`s unless a buffer of `buffer_size` bytes has `size` bytes from
+// `offset`. With `add_overflow`, a huge `offset` cannot wrap the end of the
+// field around to pass the check.
+inline void check_field(size_t buffer_size, size_t offset, size_t size) {
+  size_t end;
+  if (integers::add_overflow(offset, size, &end) || end > buffer_size) {
+    trap();
+  }
+}
+
+template <typename T>
+T load_field(const uint8_t* p, bool little_endian) {
+  T value;
+  memcpy(&value, p, sizeof(value));
+  return little_endian == kLittleEndian ? value : reverse_bytes(value);
+}
+
+template <typename T>
+void store_field(T value, uint8_t* p, bool little_endian) {
+  if (little_endian != kLittleEndian) {
+    value = reverse_bytes(value);
+  }
+  memcpy(p, &value, sizeof(value));
+}
+
+// Copies `count` `T`s from `from` to `to`, reversing the bytes of each. The
+// bulk is 16 bytes at a time, reversed within each lane by one byte shuffle
+// (e.g. `pshufb` on x86, `rev` on ARM).
+template <typename T, size_t... I>
+void byteswap_copy(const uint8_t* from,
+                   uint8_t* to,
+                   size_t count,
+                   std::index_sequence<I...>) {
+  typedef uint8_t vector __attribute__((vector_size(16)));
+  constexpr size_t kLanes = sizeof(vector) / sizeof(T);
+  size_t i = 0;
+  for (; i + kLanes <= count; i += kLanes) {
+    vector v;
+    memcpy(&v, from + i * sizeof(T), sizeof(v));
+    v = __builtin_shufflevector(v, v, (I ^ (sizeof(T) - 1))...);
+    memcpy(to + i * sizeof(T), &v, sizeof(v));
+  }
+  for (; i < count; i++) {
+    T value;
+    memcpy(&value, from + i * sizeof(T), sizeof(value));
+    value = reverse_bytes(value);
+    memcpy(to + i * sizeof(T), &value, sizeof(value));
+  }
+}
+
+// Copies `count` `T`s from `from` to `to`, in the other byte order if
+// `swap`.
+template <typename T>
+void copy_fields(const uint8_t* from, uint8_t* to, size_t count, bool swap) {
+  if (swap && sizeof(T) > 1) {
+    byteswap_copy<T>(from, to, count, std::make_index_sequence<16>{});
+  } else if (count != 0) {
+    memcpy(to, from, count * sizeof(T));
+  }
+}
+
+template <typename R>
+R load_checked(integers::span<const uint8_t> bytes,
+               size_t offset,
+               bool little_endian) {
+  using T = typename field_traits<R>::value_type;
+  assert_is_integral(T);
+  check_field(bytes.size(), offset, sizeof(T));
+  // Policy types check the value as they construct; `ranged` `trap`s if it is
+  // out of range.
+  return R(load_field<T>(bytes.data() + offset, little_endian));
+}
+
+template <typename R>
+void store_checked(R value,
+                   integers::span<uint8_t> bytes,
+                   size_t offset,
+                   bool little_endian) {
+  using T = typename field_traits<R>::value_type;
+  assert_is_integral(T);
+  check_field(bytes.size(), offset, sizeof(T));
+  store_field(static_cast<T>(value), bytes.data() + offset, little_endian);
+}
+
+template <typename T>
+void load_array(integers::span<const uint8_t> bytes,
+                integers::span<T> result,
+                bool little_endian) {
+  assert_is_integral(T);
+  if (bytes.size() / sizeof(T) < result.size()) {
+    trap();
+  }
+  copy_fields<T>(bytes.data(), reinterpret_cast<uint8_t*>(result.data()),
+                 result.size(), little_endian != kLittleEndian);
+}
+
+template <typename T>
+size_t store_array(integers::span<const T> values,
+                   integers::span<uint8_t> bytes,
+                   bool little_endian) {
+  assert_is_integral(T);
+  if (bytes.size() / sizeof(T) < values.size()) {
+    trap();
+  }
+  copy_fields<T>(reinterpret_cast<const uint8_t*>(values.data()), bytes.data(),
+                 values.size(), little_endian != kLittleEndian);
+  return values.size() * sizeof(T);
+}
+
+}  // namespace internal
+
+namespace integers {
+
+/// ## Byte Order
+///
+/// File formats and protocols store integers in a fixed byte order, at
+/// offsets that the input itself often determines. These functions read and
+/// write such fields in untrusted byte buffers: they check that the whole
+/// field is in the buffer (computing its end with `add_overflow`, so that no
+/// offset can wrap around the check), and `trap` if not. They handle any
+/// alignment.
+///
+/// The scalar functions take an integer type or a policy type: loading a
+/// `trapping<uint32_t>` reads a `uint32_t`, and loading a `ranged<T, Min,
+/// Max>` also `trap`s if the value is out of range.
+///
+///   const auto count = load_be<trapping<uint32_t>>(header, 4);
+///   const auto version = load_le<ranged<uint16_t, 1, 3>>(header, 8);
+///
+/// ### `byteswap`
+///
+/// Returns `value` with its bytes in reverse order.
+template <typename T>
+constexpr T byteswap(T value) {
+  assert_is_integral(T);
+  return internal::reverse_bytes(value);
+}
+
+/// ### `load_le`
+///
+/// Returns the little-endian `R` at `bytes[offset]`.
+template <typename R>
+R load_le(span<const uint8_t> bytes, size_t offset) {
+  return internal::load_checked<R>(bytes, offset, true);
+}
+
+/// ### `load_be`
+///
+/// Returns the big-endian `R` at `bytes[offset]`.
+template <typename R>
+R load_be(span<const uint8_t> bytes, size_t offset) {
+  return internal::load_checked<R>(bytes, offset, false);
+}
+
+/// ### `store_le`
+///
+/// Stores `value` at `bytes[offset]`, little-endian.
+template <typename T>
+void store_le(T value, span<uint8_t> bytes, size_t offset) {
+  internal::store_checked(value, bytes, offset, true);
+}
+
+/// ### `store_be`
+///
+/// Stores `value` at `bytes[offset]`, big-endian.
+template <typename T>
+void store_be(T value, span<uint8_t> bytes, size_t offset) {
+  internal::store_checked(value, bytes, offset, false);
+}
+
+/// ### `load_le`
+///
+/// Loads `result.size()` consecutive little-endian `T`s from the start of
+/// `bytes`. `trap`s if `bytes` is too short. You must give `T` explicitly
+/// when passing containers; for spans of the policy types, pass
+/// `as_underlying(result)`.
+///
+/// In the byte order of the target, this is `memcpy`. In the other, it
+/// reverses the bytes of 16 bytes of fields at a time with a byte shuffle.
+template <typename T>
+void load_le(span<const uint8_t> bytes, span<T> result) {
+  internal::load_array(bytes, result, true);
+}
+
+/// ### `load_be`
+///
+/// Loads `result.size()` consecutive big-endian `T`s from the start of
+/// `bytes`, like the bulk `load_le`.
+template <typename T>
+void load_be(span<const uint8_t> bytes, span<T> result) {
+  internal::load_array(bytes, result, false);
+}
+
+/// ### `store_le`
+///
+/// Stores `values` consecutively at the start of `bytes`, little-endian, and
+/// returns the number of bytes written. `trap`s if `bytes` is too short.
+template <typename T>
+size_t store_le(span<const T> values, span<uint8_t> bytes) {
+  return internal::store_array(values, bytes, true);
+}
+
+/// ### `store_be`
+///
+/// Stores `values` consecutively at the start of `bytes`, big-endian, like
+/// the bulk `store_le`.
+template <typename T>
+size_t store_be(span<const T> values, span<uint8_t> bytes) {
+  return internal::store_array(values, bytes, false);
+}
+
+}  // namespace integers
+
+#endif  // BYTE_ORDER_H_
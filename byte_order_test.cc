@@ -0,0 +1,135 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "byte_order.h"
+#include "test_support.h"
+
+using namespace integers;
+using namespace std;
+
+namespace {
+
+using i8 = int8_t;
+using u8 = uint8_t;
+using i16 = int16_t;
+using u16 = uint16_t;
+using i32 = int32_t;
+using u32 = uint32_t;
+using i64 = int64_t;
+using u64 = uint64_t;
+
+using Bytes = vector<u8>;
+
+void TestByteswap() {
+  static_assert(0x34 == byteswap(u8{0x34}));
+  static_assert(0x3412 == byteswap(u16{0x1234}));
+  static_assert(0x78563412 == byteswap(u32{0x12345678}));
+  static_assert(0xEFCDAB8967452301 == byteswap(u64{0x0123456789ABCDEF}));
+  static_assert(-2 == byteswap(i16{-257}));
+  EXPECT(numeric_limits<i32>::min() == byteswap(i32{0x80}));
+}
+
+void TestScalar() {
+  const Bytes bytes = {0x00, 0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC, 0xDE, 0xF0};
+
+  // Any offset, aligned or not.
+  EXPECT(0x1234 == load_be<u16>(bytes, 1));
+  EXPECT(0x3412 == load_le<u16>(bytes, 1));
+  EXPECT(0x3456789A == load_be<u32>(bytes, 2));
+  EXPECT(0x123456789ABCDEF0 == load_be<u64>(bytes, 1));
+  EXPECT(0xF0DEBC9A78563412 == load_le<u64>(bytes, 1));
+  EXPECT(-0x10 == load_be<i8>(bytes, 8));
+
+  // Policy types load their underlying type.
+  const auto count = load_be<trapping<u32>>(bytes, 1);
+  EXPECT(0x12345678u == count);
+  EXPECT_DEATH(count * 16);
+  EXPECT(i16{0x7856} == static_cast<i16>(load_le<clamping<i16>>(bytes, 3)));
+  EXPECT(u8{0x12} == static_cast<u8>(load_be<wrapping<u8>>(bytes, 1)));
+  EXPECT(0x12 == (load_be<ranged<u8, 0, 0x12>>(bytes, 1)));
+  EXPECT_DEATH((load_be<ranged<u8, 0, 0x11>>(bytes, 1)));
+
+  // The whole field must be in bounds, and huge offsets cannot wrap around.
+  EXPECT(0xBCDEF0 == (load_be<u32>(bytes, 5) & 0xFFFFFF));
+  EXPECT_DEATH(load_be<u32>(bytes, 6));
+  EXPECT_DEATH(load_le<u8>(bytes, 9));
+  EXPECT_DEATH(load_le<u16>(bytes, numeric_limits<size_t>::max()));
+  EXPECT_DEATH(load_le<u64>(bytes, numeric_limits<size_t>::max() - 6));
+  EXPECT_DEATH(load_le<u8>(span<const u8>(), 0));
+
+  Bytes out(7, 0);
+  store_be(u32{0x12345678}, out, 1);
+  store_le(trapping<u16>{0xABCD}, out, 5);
+  EXPECT((Bytes{0, 0x12, 0x34, 0x56, 0x78, 0xCD, 0xAB}) == out);
+  store_be(ranged<i16, -1, 1>{i16{-1}}, out, 0);
+  EXPECT(0xFFFF == load_le<u16>(out, 0));
+  EXPECT_DEATH(store_be(u32{0}, out, 4));
+  EXPECT_DEATH(store_le(u8{0}, out, numeric_limits<size_t>::max()));
+}
+
+template <typename T>
+void GenericTestArrays() {
+  // Enough elements for the vector loop and a tail, from an unaligned start.
+  vector<T> values(37);
+  for (size_t i = 0; i < values.size(); i++) {
+    values[i] = static_cast<T>(0x0123456789ABCDEF * (i + 1));
+  }
+  Bytes big(1 + values.size() * sizeof(T));
+  Bytes little(big.size());
+  const span<u8> big_field = span<u8>(big).subspan(1);
+  const span<u8> little_field = span<u8>(little).subspan(1);
+  EXPECT(values.size() * sizeof(T) == store_be<T>(values, big_field));
+  EXPECT(values.size() * sizeof(T) == store_le<T>(values, little_field));
+  for (size_t i = 0; i < values.size(); i++) {
+    EXPECT(values[i] == load_be<T>(big_field, i * sizeof(T)));
+    EXPECT(values[i] == load_le<T>(little_field, i * sizeof(T)));
+  }
+
+  vector<T> round_trip(values.size());
+  load_be<T>(big_field, round_trip);
+  EXPECT(values == round_trip);
+  load_le<T>(little_field, round_trip);
+  EXPECT(values == round_trip);
+
+  EXPECT_DEATH(load_be<T>(big_field.first(big_field.size() - 1), round_trip));
+  EXPECT_DEATH(store_le<T>(values, little_field.first(sizeof(T) - 1)));
+}
+
+template <class... T>
+void CallGenericTestArrays() {
+  (GenericTestArrays<T>(), ...);
+}
+
+void TestArrays() {
+  CallGenericTestArrays<i8, u8, i16, u16, i32, u32, i64, u64>();
+
+  // Policy types go through their underlying values.
+  vector<trapping<u32>> lengths(2);
+  const Bytes bytes = {0, 0, 1, 0, 0xFF, 0xFF, 0xFF, 0xFF};
+  load_be(bytes, as_underlying(span<trapping<u32>>(lengths)));
+  EXPECT(0x100u == lengths[0]);
+  EXPECT_DEATH(lengths[1] + 1);
+}
+
+}  // namespace
+
+int main() {
+  TestByteswap();
+  TestScalar();
+  TestArrays();
+}
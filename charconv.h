@@ -0,0 +1,495 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CHARCONV_H_
+#define CHARCONV_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <charconv>
+#include <limits>
+#include <system_error>
+#include <type_traits>
+
+#if __has_include(<format>)
+#include <format>
+#endif
+
+#include "clamping.h"
+#include "is_integral.h"
+#include "overflow_status.h"
+#include "ranged.h"
+#include "span.h"
+#include "trap.h"
+#include "trapping.h"
+#include "wrapping.h"
+
+namespace internal {
+
+// Returns the value of the digit `c` in bases up to 36, or 36 if `c` is not a
+// digit in any of them.
+constexpr unsigned digit_value(char c) {
+  if (c >= '0' && c <= '9') {
+    return static_cast<unsigned>(c - '0');
+  }
+  if (c >= 'a' && c <= 'z') {
+    return static_cast<unsigned>(c - 'a') + 10;
+  }
+  if (c >= 'A' && c <= 'Z') {
+    return static_cast<unsigned>(c - 'A') + 10;
+  }
+  return 36;
+}
+
+// Returns the magnitude of the most negative value of `T` if `negative`, and
+// otherwise `T`’s maximum.
+template <typename T>
+constexpr std::make_unsigned_t<T> max_magnitude(bool negative) {
+  using U = std::make_unsigned_t<T>;
+  constexpr U kMax = static_cast<U>(std::numeric_limits<T>::max());
+  return negative ? static_cast<U>(kMax + 1) : kMax;
+}
+
+// Stores the value of `magnitude` with the given sign in `*value`, or returns
+// `errc::result_out_of_range` (leaving `*value` unchanged) if `T` cannot
+// represent it.
+template <typename T>
+std::errc store_magnitude(std::make_unsigned_t<T> magnitude,
+                          bool negative,
+                          T* value) {
+  using U = std::make_unsigned_t<T>;
+  if (magnitude > max_magnitude<T>(negative)) {
+    return std::errc::result_out_of_range;
+  }
+  *value = static_cast<T>(negative ? static_cast<U>(U{0} - magnitude)
+                                   : magnitude);
+  return std::errc{};
+}
+
+// Parses an integer like `std::from_chars`: an optional '-' (if `T` is
+// signed) and then the longest run of digits in `base`. On overflow, the
+// result points past the digits, `*value` is unchanged, and `*negative` says
+// which end of `T`’s range the number is beyond.
+//
+// Each digit is accumulated with `mul_overflow` and `add_overflow` on the
+// magnitude, so the check is exact for every width, and the digits after an
+// overflow are still consumed.
+template <typename T>
+std::from_chars_result parse_integer(const char* first,
+                                     const char* last,
+                                     int base,
+                                     T* value,
+                                     bool* negative) {
+  using U = std::make_unsigned_t<T>;
+  *negative = std::is_signed_v<T> && first != last && *first == '-';
+  const char* p = first + *negative;
+  const char* const digits = p;
+  U magnitude = 0;
+  bool overflow = false;
+  for (; p != last; p++) {
+    const unsigned digit = digit_value(*p);
+    if (digit >= static_cast<unsigned>(base)) {
+      break;
+    }
+    overflow |= integers::mul_overflow(magnitude, static_cast<U>(base),
+                                       &magnitude);
+    overflow |= integers::add_overflow(magnitude, static_cast<U>(digit),
+                                       &magnitude);
+  }
+  if (p == digits) {
+    return {first, std::errc::invalid_argument};
+  }
+  if (overflow) {
+    return {p, std::errc::result_out_of_range};
+  }
+  return {p, store_magnitude(magnitude, *negative, value)};
+}
+
+constexpr uint64_t kDigitHighNibbles = 0xF0F0F0F0F0F0F0F0u;
+constexpr uint64_t kDigitZeros = 0x3030303030303030u;
+
+// Returns the 8 bytes at `p` as a word, the first in the low byte.
+inline uint64_t load_digits(const char* p) {
+  uint64_t word;
+  memcpy(&word, p, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  word = __builtin_bswap64(word);
+#endif
+  return word;
+}
+
+// Returns the number of leading bytes of `word` that are ASCII decimal
+// digits, up to 8. A byte is a digit if its high nibble is 3 both before and
+// after adding 6 to it. (A carry out of a byte of 0xFA or more can corrupt
+// the bytes after it, but that byte is not a digit, so the count ends there
+// regardless.)
+inline size_t count_digits(uint64_t word) {
+  const uint64_t not_digits =
+      ((word & kDigitHighNibbles) ^ kDigitZeros) |
+      (((word + 0x0606060606060606u) & kDigitHighNibbles) ^ kDigitZeros);
+  return not_digits == 0
+             ? 8
+             : static_cast<size_t>(__builtin_ctzll(not_digits)) / 8;
+}
+
+// Returns the value of the 8 decimal digits in `word`, the most significant
+// in the low byte, in 3 multiplications: each combines adjacent pairs of
+// numbers into numbers of twice as many digits. Bytes of 0 count as leading
+// '0's.
+inline uint64_t parse_eight_digits(uint64_t word) {
+  word = ((word & 0x0F0F0F0F0F0F0F0Fu) * (1 + (10 << 8))) >> 8;
+  word = ((word & 0x00FF00FF00FF00FFu) * (1 + (100 << 16))) >> 16;
+  return ((word & 0x0000FFFF0000FFFFu) * (1 + (uint64_t{10000} << 32))) >> 32;
+}
+
+// Returns the value of the first `count` (in [1, 8]) digits of `word`.
+inline uint64_t parse_digits(uint64_t word, size_t count) {
+  // Shifting the digits to the high end fills the low end with leading 0s.
+  return parse_eight_digits(word << (8 * (8 - count)));
+}
+
+constexpr uint64_t kPowersOf10[] = {
+    1,      10,      100,      1000,      10000,
+    100000, 1000000, 10000000, 100000000,
+};
+
+// Parses a decimal integer like `parse_integer`, but if there are 24 bytes to
+// read after the sign, and up to 19 digits (which always fit `uint64_t`) in
+// them, reads them a word of 8 at a time without a loop. Otherwise falls back
+// to `parse_integer`.
+template <typename T>
+std::from_chars_result parse_decimal(const char* first,
+                                     const char* last,
+                                     T* value,
+                                     bool* negative) {
+  using U = std::make_unsigned_t<T>;
+  const bool sign = std::is_signed_v<T> && first != last && *first == '-';
+  const char* const p = first + sign;
+  if (last - p < 24) {
+    return parse_integer(first, last, 10, value, negative);
+  }
+  uint64_t magnitude = 0;
+  size_t count = 0;
+  for (size_t word = 0; word < 3; word++) {
+    const uint64_t digits = load_digits(p + count);
+    const size_t digit_count = count_digits(digits);
+    if (digit_count != 0) {
+      magnitude = magnitude * kPowersOf10[digit_count] +
+                  parse_digits(digits, digit_count);
+    }
+    count += digit_count;
+    if (digit_count < 8) {
+      break;
+    }
+  }
+  if (count == 0) {
+    return {first, std::errc::invalid_argument};
+  }
+  if (count > 19) {
+    return parse_integer(first, last, 10, value, negative);
+  }
+  *negative = sign;
+  if (magnitude > max_magnitude<T>(sign)) {
+    return {p + count, std::errc::result_out_of_range};
+  }
+  return {p + count, store_magnitude(static_cast<U>(magnitude), sign, value)};
+}
+
+// Reports a number out of `T`’s range per the trapping policy: `trap`s, or in
+// sticky mode records `overflow_flags::cast`.
+inline void parse_overflow() {
+#if defined(INTEGERS_STICKY_OVERFLOW)
+  integers::record_overflow(true, integers::overflow_flags::cast);
+#else
+  trap();
+#endif
+}
+
+}  // namespace internal
+
+namespace integers {
+
+/// ## Parsing
+///
+/// These functions parse integers from text like `std::from_chars`: an
+/// optional '-' (for signed types only) and then digits in `base`, with no
+/// leading whitespace, '+', or base prefix. They return a
+/// `std::from_chars_result`, whose `ptr` points past the number, and whose
+/// `ec` is `std::errc::invalid_argument` (with `ptr` at `first`) if there is
+/// no number.
+///
+/// Unlike `strtoll` followed by a cast, they detect overflow exactly, for the
+/// target type rather than for `long long`, and handle it per the type’s
+/// policy. They `trap` if `base` is not in [2, 36].
+///
+/// ### `from_chars`
+///
+/// Parses the number at `first` into `value`. `trap`s if `T` cannot represent
+/// it.
+///
+/// If `INTEGERS_STICKY_OVERFLOW` is defined, such a number is instead recorded
+/// as `overflow_flags::cast`, and the result is
+/// `std::errc::result_out_of_range` with `value` unchanged.
+template <typename T>
+std::from_chars_result from_chars(const char* first,
+                                  const char* last,
+                                  trapping<T>& value,
+                                  int base = 10) {
+  if (base < 2 || base > 36) {
+    trap();
+  }
+  T parsed;
+  bool negative;
+  const std::from_chars_result result =
+      internal::parse_integer(first, last, base, &parsed, &negative);
+  if (result.ec == std::errc::result_out_of_range) {
+    internal::parse_overflow();
+  } else if (result.ec == std::errc{}) {
+    value = parsed;
+  }
+  return result;
+}
+
+/// ### `from_chars`
+///
+/// Parses the number at `first` into `value`. If `T` cannot represent it,
+/// `value` becomes `T`’s minimum or maximum, and the parse still succeeds.
+template <typename T>
+std::from_chars_result from_chars(const char* first,
+                                  const char* last,
+                                  clamping<T>& value,
+                                  int base = 10) {
+  if (base < 2 || base > 36) {
+    trap();
+  }
+  T parsed;
+  bool negative;
+  std::from_chars_result result =
+      internal::parse_integer(first, last, base, &parsed, &negative);
+  if (result.ec == std::errc::result_out_of_range) {
+    value = negative ? std::numeric_limits<T>::min()
+                     : std::numeric_limits<T>::max();
+    result.ec = std::errc{};
+  } else if (result.ec == std::errc{}) {
+    value = parsed;
+  }
+  return result;
+}
+
+/// ### `from_chars_column`
+///
+/// Parses decimal numbers separated by `delimiter`, such as a column of a CSV
+/// file (with `'\n'`) or a row of one (with `','`), into `result`, until
+/// `result` is full or a field is not a number that `T` can represent. Each
+/// number must be followed by `delimiter` or by `last`. Returns the number of
+/// values parsed, and sets `*end` past the delimiter of the last of them.
+///
+/// Numbers of up to 19 digits that are at least 24 bytes from `last` are
+/// parsed without a loop over their digits: 8 digits at a time are validated
+/// and converted in a few word operations.
+template <typename T>
+[[nodiscard]] size_t from_chars_column(const char* first,
+                                       const char* last,
+                                       char delimiter,
+                                       span<T> result,
+                                       const char** end) {
+  assert_is_integral(T);
+  const char* p = first;
+  size_t count = 0;
+  for (; count < result.size(); count++) {
+    bool negative;
+    const std::from_chars_result field =
+        internal::parse_decimal(p, last, &result[count], &negative);
+    if (field.ec != std::errc{} ||
+        (field.ptr != last && *field.ptr != delimiter)) {
+      break;
+    }
+    p = field.ptr + (field.ptr != last);
+  }
+  *end = p;
+  return count;
+}
+
+/// ### `trapping_from_chars_column`
+///
+/// Parses `result.size()` decimal numbers like `from_chars_column`, and
+/// returns a pointer past the delimiter of the last. `trap`s if a field is
+/// not a number or the text ends too soon, and if `T` cannot represent a
+/// number. You must give `T` explicitly when passing containers:
+///
+///   std::vector<uint32_t> ids(rows);
+///   const char* rest = trapping_from_chars_column<uint32_t>(
+///       text.data(), text.data() + text.size(), '\n', ids);
+///
+/// If `INTEGERS_STICKY_OVERFLOW` is defined, numbers that `T` cannot
+/// represent are instead recorded as `overflow_flags::cast`, and become
+/// `T`’s minimum or maximum.
+template <typename T>
+const char* trapping_from_chars_column(const char* first,
+                                       const char* last,
+                                       char delimiter,
+                                       span<T> result) {
+  assert_is_integral(T);
+  const char* p = first;
+  for (T& x : result) {
+    bool negative;
+    const std::from_chars_result field =
+        internal::parse_decimal(p, last, &x, &negative);
+    if (field.ec == std::errc::result_out_of_range) {
+      internal::parse_overflow();
+      x = negative ? std::numeric_limits<T>::min()
+                   : std::numeric_limits<T>::max();
+    } else if (field.ec != std::errc{}) {
+      trap();
+    }
+    if (field.ptr != last && *field.ptr != delimiter) {
+      trap();
+    }
+    p = field.ptr + (field.ptr != last);
+  }
+  return p;
+}
+
+/// ## Formatting
+///
+/// These functions format the policy types as their underlying `T`, with
+/// `std::to_chars`: there is no locale, no stream state, and no allocation.
+/// (`operator<<` remains for streams.) Like `std::to_chars`, they return
+/// `std::errc::value_too_large`, with `ptr` at `last`, if the number does not
+/// fit in `[first, last)`.
+///
+/// In C++20 with `<format>`, `std::format` formats the policy types too, with
+/// the format specs of `T`:
+///
+///   std::format("{:>8x}", trapping<uint32_t>{255})  // "      ff"
+///
+/// ### `max_chars`
+///
+/// The most characters that formatting any `T` in base 10 takes: a '-' and
+/// `digits10 + 1` digits.
+template <typename T>
+constexpr size_t max_chars =
+    static_cast<size_t>(std::numeric_limits<T>::digits10) + 1 +
+    std::is_signed_v<T>;
+
+/// ### `to_chars`
+///
+/// Formats `value` at `first` in `base`.
+template <typename T>
+std::to_chars_result to_chars(char* first,
+                              char* last,
+                              trapping<T> value,
+                              int base = 10) {
+  return std::to_chars(first, last, static_cast<T>(value), base);
+}
+
+/// ### `to_chars`
+///
+/// Formats `value` at `first` in `base`.
+template <typename T>
+std::to_chars_result to_chars(char* first,
+                              char* last,
+                              clamping<T> value,
+                              int base = 10) {
+  return std::to_chars(first, last, static_cast<T>(value), base);
+}
+
+/// ### `to_chars`
+///
+/// Formats `value` at `first` in `base`.
+template <typename T>
+std::to_chars_result to_chars(char* first,
+                              char* last,
+                              wrapping<T> value,
+                              int base = 10) {
+  return std::to_chars(first, last, static_cast<T>(value), base);
+}
+
+/// ### `to_chars`
+///
+/// Formats `value` at `first` in `base`.
+template <typename T, T Min, T Max>
+std::to_chars_result to_chars(char* first,
+                              char* last,
+                              ranged<T, Min, Max> value,
+                              int base = 10) {
+  return std::to_chars(first, last, static_cast<T>(value), base);
+}
+
+/// ### `to_chars_column`
+///
+/// Formats each element of `values` in base 10, each followed by `delimiter`,
+/// consecutively at the start of `out`, and returns the number of characters
+/// written. The output is the input of `from_chars_column`. `trap`s if `out`
+/// is too small; `values.size() * (max_chars<T> + 1)` characters are always
+/// enough. You must give `T` explicitly when passing containers; for spans of
+/// the policy types, pass `as_underlying(values)`.
+template <typename T>
+size_t to_chars_column(span<const T> values, char delimiter, span<char> out) {
+  assert_is_integral(T);
+  char* p = out.data();
+  char* const last = p + out.size();
+  for (const T value : values) {
+    const std::to_chars_result result = std::to_chars(p, last, value);
+    if (result.ec != std::errc{} || result.ptr == last) {
+      trap();
+    }
+    *result.ptr = delimiter;
+    p = result.ptr + 1;
+  }
+  return static_cast<size_t>(p - out.data());
+}
+
+}  // namespace integers
+
+#if defined(__cpp_lib_format)
+
+namespace internal {
+
+// Formats a policy type as its underlying `T`, with `T`’s format specs.
+template <typename T, typename CharT>
+struct underlying_formatter : std::formatter<T, CharT> {
+  template <typename Number, typename FormatContext>
+  auto format(Number value, FormatContext& context) const {
+    return std::formatter<T, CharT>::format(static_cast<T>(value), context);
+  }
+};
+
+}  // namespace internal
+
+namespace std {
+
+template <typename T, typename CharT>
+struct formatter<integers::trapping<T>, CharT>
+    : internal::underlying_formatter<T, CharT> {};
+
+template <typename T, typename CharT>
+struct formatter<integers::clamping<T>, CharT>
+    : internal::underlying_formatter<T, CharT> {};
+
+template <typename T, typename CharT>
+struct formatter<integers::wrapping<T>, CharT>
+    : internal::underlying_formatter<T, CharT> {};
+
+template <typename T, T Min, T Max, typename CharT>
+struct formatter<integers::ranged<T, Min, Max>, CharT>
+    : internal::underlying_formatter<T, CharT> {};
+
+}  // namespace std
+
+#endif  // defined(__cpp_lib_format)
+
+#endif  // CHARCONV_H_
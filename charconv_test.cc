@@ -0,0 +1,298 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "charconv.h"
+#include "test_support.h"
+
+using namespace integers;
+using namespace std;
+
+namespace {
+
+using i8 = int8_t;
+using u8 = uint8_t;
+using i16 = int16_t;
+using u16 = uint16_t;
+using i32 = int32_t;
+using u32 = uint32_t;
+using i64 = int64_t;
+using u64 = uint64_t;
+
+template <typename Number>
+from_chars_result Parse(const string& text, Number& value, int base = 10) {
+  return integers::from_chars(text.data(), text.data() + text.size(), value,
+                              base);
+}
+
+template <typename T>
+void GenericTestFromChars() {
+  constexpr T max = numeric_limits<T>::max();
+  constexpr T min = numeric_limits<T>::min();
+  const string max_text = to_string(max);
+  const string min_text = to_string(min);
+
+  trapping<T> t{0};
+  EXPECT(errc{} == Parse(max_text, t).ec);
+  EXPECT(max == t);
+  EXPECT(errc{} == Parse(min_text, t).ec);
+  EXPECT(min == t);
+  EXPECT(errc{} == Parse("0000000000000000000000042", t).ec);
+  EXPECT(42 == t);
+
+  // Overflow by a factor of 10, or by 1, is exact for every width.
+  EXPECT_DEATH(Parse(max_text + "0", t));
+  EXPECT_DEATH(Parse(max == numeric_limits<u64>::max() ? "18446744073709551616"
+                                                      : to_string(u64{max} + 1),
+                     t));
+
+  clamping<T> c{0};
+  const string big_text = max_text + "9";
+  const from_chars_result big = Parse(big_text, c);
+  EXPECT(errc{} == big.ec);
+  EXPECT(big_text.data() + big_text.size() == big.ptr);
+  EXPECT(max == c);
+  EXPECT(errc{} == Parse("99999999999999999999999999", c).ec);
+  EXPECT(max == c);
+  if constexpr (is_signed_v<T>) {
+    EXPECT_DEATH(Parse(min_text + "0", t));
+    EXPECT(errc{} == Parse(min_text + "0", c).ec);
+    EXPECT(min == c);
+    EXPECT(errc{} == Parse("-0", t).ec);
+    EXPECT(0 == t);
+  } else {
+    // As with `std::from_chars`, unsigned types take no sign.
+    EXPECT(errc::invalid_argument == Parse("-1", t).ec);
+    EXPECT(errc::invalid_argument == Parse("-1", c).ec);
+  }
+}
+
+template <class... T>
+void CallGenericTestFromChars() {
+  (GenericTestFromChars<T>(), ...);
+}
+
+void TestFromChars() {
+  CallGenericTestFromChars<i8, u8, i16, u16, i32, u32, i64, u64>();
+
+  trapping<i32> t{7};
+  const string text = "123abc";
+  const from_chars_result prefix = Parse(text, t);
+  EXPECT(errc{} == prefix.ec);
+  EXPECT(text.data() + 3 == prefix.ptr);
+  EXPECT(123 == t);
+
+  for (const char* bad : {"", "x", "+1", " 1", "-", "-x"}) {
+    const string input = bad;
+    const from_chars_result result = Parse(input, t);
+    EXPECT(errc::invalid_argument == result.ec);
+    EXPECT(input.data() == result.ptr);
+    EXPECT(123 == t);
+  }
+
+  EXPECT(errc{} == Parse("7fffffff", t, 16).ec);
+  EXPECT(numeric_limits<i32>::max() == t);
+  EXPECT(errc{} == Parse("-80000000", t, 16).ec);
+  EXPECT(numeric_limits<i32>::min() == t);
+  EXPECT_DEATH(Parse("80000000", t, 16));
+  EXPECT(errc{} == Parse("zz", t, 36).ec);
+  EXPECT(35 * 36 + 35 == t);
+  EXPECT(errc{} == Parse("1012", t, 2).ec);
+  EXPECT(5 == t);
+
+  clamping<u8> c{0};
+  EXPECT(errc{} == Parse("FFF", c, 16).ec);
+  EXPECT(u8{255} == c);
+
+  EXPECT_DEATH(Parse("1", t, 1));
+  EXPECT_DEATH(Parse("1", t, 37));
+}
+
+// Parses `text` into a column of `T`s, and checks that it matches
+// `std::from_chars` field by field.
+template <typename T>
+void CheckColumn(const string& text, char delimiter) {
+  const char* const last = text.data() + text.size();
+  vector<T> expected;
+  const char* p = text.data();
+  const char* expected_end = p;
+  while (p != last) {
+    T value;
+    const from_chars_result field = std::from_chars(p, last, value);
+    if (field.ec != errc{} || (field.ptr != last && *field.ptr != delimiter)) {
+      break;
+    }
+    expected.push_back(value);
+    p = field.ptr + (field.ptr != last);
+    expected_end = p;
+  }
+
+  vector<T> actual(expected.size() + 1);
+  const char* end = nullptr;
+  EXPECT(expected.size() ==
+         from_chars_column<T>(text.data(), last, delimiter, actual, &end));
+  EXPECT(expected_end == end);
+  actual.pop_back();
+  EXPECT(expected == actual);
+}
+
+template <typename T>
+void GenericTestColumn() {
+  // Every length of number, at every alignment, near and far from the end.
+  mt19937_64 random(42);
+  for (size_t digits = 1; digits <= 21; digits++) {
+    for (const char* sign : {"", "-"}) {
+      string text;
+      for (size_t i = 0; i < 40; i++) {
+        text += sign;
+        text += to_string(1 + random() % 9);
+        for (size_t j = 1; j < digits; j++) {
+          text += to_string(random() % 10);
+        }
+        text += '\n';
+        CheckColumn<T>(text, '\n');
+      }
+      text.pop_back();
+      CheckColumn<T>(text, '\n');
+    }
+  }
+
+  CheckColumn<T>(to_string(numeric_limits<T>::max()) + "," +
+                     to_string(numeric_limits<T>::min()) + ",0,000000000000001",
+                 ',');
+}
+
+template <class... T>
+void CallGenericTestColumn() {
+  (GenericTestColumn<T>(), ...);
+}
+
+void TestColumn() {
+  CallGenericTestColumn<i8, u8, i16, u16, i32, u32, i64, u64>();
+
+  const string text = "1,2,x,4";
+  vector<i32> values(4);
+  const char* end = nullptr;
+  EXPECT(2 == from_chars_column<i32>(text.data(), text.data() + text.size(),
+                                     ',', values, &end));
+  EXPECT(text.data() + 4 == end);
+  EXPECT(1 == values[0] && 2 == values[1]);
+
+  // A field must end at the delimiter.
+  const string wrong = "12;3";
+  EXPECT(0 == from_chars_column<i32>(wrong.data(), wrong.data() + wrong.size(),
+                                     ',', values, &end));
+  EXPECT(wrong.data() == end);
+
+  const string column = "-5\n100\n300\n7\n";
+  const char* const last = column.data() + column.size();
+  vector<u8> bytes(4);
+  EXPECT(0 == from_chars_column<u8>(column.data(), last, '\n', bytes, &end));
+  vector<i8> narrow(4);
+  EXPECT(2 == from_chars_column<i8>(column.data(), last, '\n', narrow, &end));
+  EXPECT(column.data() + 7 == end);
+  EXPECT(last == trapping_from_chars_column<i32>(column.data(), last, '\n',
+                                                 values));
+  EXPECT((vector<i32>{-5, 100, 300, 7}) == values);
+
+  vector<i32> more(5);
+  EXPECT_DEATH(
+      trapping_from_chars_column<i32>(column.data(), last, '\n', more));
+  vector<i16> one(1);
+  EXPECT_DEATH(trapping_from_chars_column<i16>(column.data(), last, ',', one));
+  EXPECT_DEATH(
+      trapping_from_chars_column<i8>(column.data(), last, '\n', narrow));
+}
+
+template <typename T>
+void GenericTestToChars() {
+  constexpr T max = numeric_limits<T>::max();
+  constexpr T min = numeric_limits<T>::min();
+  char buffer[max_chars<T>];
+  char* const last = buffer + sizeof(buffer);
+
+  // The longest number takes exactly `max_chars<T>`.
+  const T longest = is_signed_v<T> ? min : max;
+  const to_chars_result result = to_chars(buffer, last, trapping<T>{longest});
+  EXPECT(errc{} == result.ec);
+  EXPECT(last == result.ptr);
+  EXPECT(to_string(longest) == string(buffer, result.ptr));
+
+  EXPECT(to_string(max) ==
+         string(buffer, to_chars(buffer, last, clamping<T>{max}).ptr));
+  EXPECT(to_string(max) ==
+         string(buffer, to_chars(buffer, last, wrapping<T>{max}).ptr));
+  EXPECT("7f" == string(buffer, to_chars(buffer, last,
+                                         ranged<T, 0, 127>{T{127}}, 16)
+                                    .ptr));
+
+  const to_chars_result small = to_chars(buffer, buffer + 1, trapping<T>{max});
+  EXPECT(errc::value_too_large == small.ec);
+  EXPECT(buffer + 1 == small.ptr);
+}
+
+template <class... T>
+void CallGenericTestToChars() {
+  (GenericTestToChars<T>(), ...);
+}
+
+void TestToChars() {
+  CallGenericTestToChars<i8, u8, i16, u16, i32, u32, i64, u64>();
+
+#if defined(__cpp_lib_format)
+  EXPECT("      ff" == format("{:>8x}", trapping<u32>{255}));
+  EXPECT("-128 127 255" ==
+         format("{} {} {}", clamping<i8>{-128}, wrapping<i8>{127},
+                ranged<u8, 0, 255>{u8{255}}));
+#endif
+}
+
+void TestToCharsColumn() {
+  const vector<i64> values = {0, -1, numeric_limits<i64>::min(),
+                              numeric_limits<i64>::max(), 42};
+  string text(values.size() * (max_chars<i64> + 1), '\0');
+  text.resize(to_chars_column<i64>(values, '\n', text));
+  EXPECT("0\n-1\n-9223372036854775808\n9223372036854775807\n42\n" == text);
+
+  vector<i64> parsed(values.size());
+  EXPECT(text.data() + text.size() ==
+         trapping_from_chars_column<i64>(text.data(), text.data() + text.size(),
+                                         '\n', parsed));
+  EXPECT(values == parsed);
+
+  // Policy types format through their underlying values.
+  const vector<trapping<u16>> counts = {trapping<u16>{7}, trapping<u16>{300}};
+  char row[8];
+  EXPECT(6 == to_chars_column(as_underlying(span<const trapping<u16>>(counts)),
+                              ',', row));
+  EXPECT("7,300," == string(row, 6));
+
+  EXPECT_DEATH(to_chars_column<i64>(values, '\n', span<char>(text).first(5)));
+  // The delimiter must fit too.
+  EXPECT_DEATH(to_chars_column<u16>(vector<u16>{300}, ',', span<char>(row, 3)));
+}
+
+}  // namespace
+
+int main() {
+  TestFromChars();
+  TestColumn();
+  TestToChars();
+  TestToCharsColumn();
+}
@@ -0,0 +1,237 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CHECKED_H_
+#define CHECKED_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <limits>
+#include <type_traits>
+
+#include "is_integral.h"
+#include "trap.h"
+#include "trapping.h"
+
+namespace integers {
+
+/// ## `checked<T>`
+///
+/// This template class implements integer types that, like floating-point
+/// NaN, become and stay invalid when an operation overflows, underflows,
+/// divides by 0, or narrows lossily. Operations never branch: each one ORs
+/// the overflow flag of the corresponding `*_overflow` function into the
+/// result’s invalid flag. You check the result once, at the end, with
+/// `value_or_trap` (or `is_valid`):
+///
+///   checked<int64_t> sum = 0;
+///   for (size_t i = 0; i < count; i++) {
+///     sum += checked<int64_t>(a[i]) * b[i];
+///   }
+///   int64_t result = sum.value_or_trap();
+///
+/// `trapping<T>`, by contrast, branches after every operation. That is
+/// simpler to reason about, but it keeps the compiler from combining or
+/// vectorizing operations in tight loops.
+///
+/// The invalid flag is stored as a `T`, so `checked<T>` is twice the size of
+/// `T` but has no padding. (A reserved sentinel value would keep it the same
+/// size as `T`, but at the cost of a compare on every result and one less
+/// value in `T`’s range.)
+///
+/// The value of an invalid `checked<T>` is unspecified (but not undefined).
+template <typename T>
+class checked {
+  assert_is_integral(T);
+
+  using Self = checked<T>;
+
+ public:
+  /// ### `checked`
+  ///
+  /// The default constructor. The contents of the object are undefined. 😕
+  /// Best practice is to use `-ftrivial-auto-var-init=zero` or to
+  /// explicitly initialize the object.
+  checked() = default;
+
+  /// ### `checked`
+  ///
+  /// Constructs and initializes a valid value.
+  template <typename U, std::enable_if_t<std::is_same_v<T, U>, int> = 0>
+  checked(U value) : value_(value), invalid_(0) {}
+
+  /// ### `checked`
+  ///
+  /// Constructs and initializes. The result is invalid if `T` cannot
+  /// represent `value`.
+  template <typename U, std::enable_if_t<!std::is_same_v<T, U>, int> = 0>
+  explicit checked(U value)
+      : value_(static_cast<T>(value)),
+        invalid_(static_cast<T>(!in_range<T>(value))) {}
+
+  /// ### `is_valid`
+  ///
+  /// Returns true if no operation leading to this value has overflowed.
+  bool is_valid() const { return invalid_ == 0; }
+
+  /// ### `value_or_trap`
+  ///
+  /// Returns the value, or `trap`s if it is invalid.
+  T value_or_trap() const {
+    if (!is_valid()) {
+      trap();
+    }
+    return value_;
+  }
+
+  /// ### `value_or`
+  ///
+  /// Returns the value, or `fallback` if it is invalid.
+  T value_or(T fallback) const { return is_valid() ? value_ : fallback; }
+
+  /// ### `operator+=`
+  ///
+  /// Adds `x`. The result is invalid if either operand was invalid or if the
+  /// addition overflows.
+  Self& operator+=(Self x) {
+    const bool overflow =
+        internal::vector_add_overflow(value_, x.value_, &value_);
+    invalid_ |= x.invalid_ | static_cast<T>(overflow);
+    return *this;
+  }
+
+  /// ### `operator+`
+  ///
+  /// Returns the sum of `lhs` and `rhs`.
+  friend Self operator+(Self lhs, Self rhs) {
+    lhs += rhs;
+    return lhs;
+  }
+
+  /// ### `operator-=`
+  ///
+  /// Subtracts `x`. The result is invalid if either operand was invalid or if
+  /// the subtraction overflows.
+  Self& operator-=(Self x) {
+    const bool overflow =
+        internal::vector_sub_overflow(value_, x.value_, &value_);
+    invalid_ |= x.invalid_ | static_cast<T>(overflow);
+    return *this;
+  }
+
+  /// ### `operator-`
+  ///
+  /// Returns the difference of `lhs` and `rhs`.
+  friend Self operator-(Self lhs, Self rhs) {
+    lhs -= rhs;
+    return lhs;
+  }
+
+  /// ### `operator-`
+  ///
+  /// Returns the negation of `x`. The result is invalid if `x` was invalid or
+  /// if `T` cannot represent the negation.
+  friend Self operator-(Self x) { return Self{T{0}} - x; }
+
+  /// ### `operator*=`
+  ///
+  /// Multiplies by `x`. The result is invalid if either operand was invalid or
+  /// if the multiplication overflows.
+  Self& operator*=(Self x) {
+    const bool overflow =
+        internal::vector_mul_overflow(value_, x.value_, &value_);
+    invalid_ |= x.invalid_ | static_cast<T>(overflow);
+    return *this;
+  }
+
+  /// ### `operator*`
+  ///
+  /// Returns the product of `lhs` and `rhs`.
+  friend Self operator*(Self lhs, Self rhs) {
+    lhs *= rhs;
+    return lhs;
+  }
+
+  /// ### `operator/=`
+  ///
+  /// Divides by `divisor`. The result is invalid if either operand was invalid,
+  /// if `divisor` is 0, or if the division overflows.
+  Self& operator/=(Self divisor) {
+    const bool bad = internal::check_bad_division(value_, divisor.value_);
+    // Divide by 1 instead, so that the (invalid) result is still defined.
+    value_ = static_cast<T>(value_ / (bad ? T{1} : divisor.value_));
+    invalid_ |= divisor.invalid_ | static_cast<T>(bad);
+    return *this;
+  }
+
+  /// ### `operator/`
+  ///
+  /// Returns the quotient of `dividend` and `divisor`.
+  friend Self operator/(Self dividend, Self divisor) {
+    dividend /= divisor;
+    return dividend;
+  }
+
+  /// ### `operator%=`
+  ///
+  /// Divides by `divisor`, keeping the remainder. The result is invalid if
+  /// either operand was invalid, if `divisor` is 0, or if the division
+  /// overflows.
+  Self& operator%=(Self divisor) {
+    const bool bad = internal::check_bad_division(value_, divisor.value_);
+    value_ = static_cast<T>(value_ % (bad ? T{1} : divisor.value_));
+    invalid_ |= divisor.invalid_ | static_cast<T>(bad);
+    return *this;
+  }
+
+  /// ### `operator%`
+  ///
+  /// Returns the remainder of `dividend` and `divisor`.
+  friend Self operator%(Self dividend, Self divisor) {
+    dividend %= divisor;
+    return dividend;
+  }
+
+  /// ### `operator==`
+  ///
+  /// Returns true if `lhs` and `rhs` are both valid and equal. Like NaN, an
+  /// invalid value is not equal to anything, including itself.
+  friend bool operator==(Self lhs, Self rhs) {
+    return (lhs.invalid_ | rhs.invalid_) == 0 && lhs.value_ == rhs.value_;
+  }
+
+  /// ### `operator!=`
+  ///
+  /// Returns the opposite of `operator==`.
+  friend bool operator!=(Self lhs, Self rhs) { return !(lhs == rhs); }
+
+ private:
+  T value_;
+  T invalid_;
+};
+
+static_assert(std::is_trivial_v<checked<int>>, "`checked<T>` must be trivial");
+static_assert(sizeof(checked<int8_t>) == 2 * sizeof(int8_t),
+              "sizeof(checked<int8_t>) must == 2 * sizeof(int8_t)");
+static_assert(sizeof(checked<int16_t>) == 2 * sizeof(int16_t),
+              "sizeof(checked<int16_t>) must == 2 * sizeof(int16_t)");
+static_assert(sizeof(checked<int32_t>) == 2 * sizeof(int32_t),
+              "sizeof(checked<int32_t>) must == 2 * sizeof(int32_t)");
+static_assert(sizeof(checked<int64_t>) == 2 * sizeof(int64_t),
+              "sizeof(checked<int64_t>) must == 2 * sizeof(int64_t)");
+
+}  // namespace integers
+
+#endif  // CHECKED_H_
@@ -0,0 +1,143 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <limits>
+
+#include "checked.h"
+#include "test_support.h"
+
+using namespace integers;
+using namespace std;
+
+namespace {
+
+using i8 = int8_t;
+using u8 = uint8_t;
+using i16 = int16_t;
+using u16 = uint16_t;
+using i32 = int32_t;
+using u32 = uint32_t;
+using i64 = int64_t;
+using u64 = uint64_t;
+
+template <typename T>
+void GenericTestArithmetic() {
+  constexpr T max = numeric_limits<T>::max();
+  constexpr T min = numeric_limits<T>::min();
+  {
+    checked<T> x{T{6}};
+    x = x * checked<T>{T{7}} + checked<T>{T{2}} - checked<T>{T{2}};
+    EXPECT(x.is_valid());
+    EXPECT(42 == x.value_or_trap());
+    x /= checked<T>{T{5}};
+    EXPECT(8 == x.value_or_trap());
+    x %= checked<T>{T{5}};
+    EXPECT(3 == x.value_or_trap());
+  }
+  {
+    checked<T> x{max};
+    x += checked<T>{T{1}};
+    EXPECT(!x.is_valid());
+    // Once invalid, always invalid, even if later operations would bring the
+    // value back into range.
+    x -= checked<T>{T{1}};
+    EXPECT(!x.is_valid());
+    x *= checked<T>{T{0}};
+    EXPECT(!x.is_valid());
+    EXPECT(42 == x.value_or(T{42}));
+    EXPECT_DEATH(x.value_or_trap());
+  }
+  {
+    checked<T> x{min};
+    x = x - checked<T>{T{1}};
+    EXPECT(!x.is_valid());
+  }
+  {
+    checked<T> x{max};
+    x = x * checked<T>{T{2}};
+    EXPECT(!x.is_valid());
+  }
+  {
+    checked<T> x{T{1}};
+    x = checked<T>{max} / checked<T>{T{0}} + x;
+    EXPECT(!x.is_valid());
+  }
+  {
+    checked<T> x{T{1}};
+    x = x % checked<T>{T{0}};
+    EXPECT(!x.is_valid());
+  }
+}
+
+template <class... T>
+void CallGenericTestArithmetic() {
+  (GenericTestArithmetic<T>(), ...);
+}
+
+void TestArithmetic() {
+  CallGenericTestArithmetic<i8, u8, i16, u16, i32, u32, i64, u64>();
+}
+
+void TestSigned() {
+  {
+    checked<i32> x = -checked<i32>{numeric_limits<i32>::min()};
+    EXPECT(!x.is_valid());
+  }
+  {
+    checked<i32> x = -checked<i32>{42};
+    EXPECT(-42 == x.value_or_trap());
+  }
+  {
+    checked<i32> x =
+        checked<i32>{numeric_limits<i32>::min()} / checked<i32>{-1};
+    EXPECT(!x.is_valid());
+  }
+}
+
+void TestConstructorU() {
+  {
+    checked<u8> x{-1};
+    EXPECT(!x.is_valid());
+  }
+  {
+    checked<u8> x{255};
+    EXPECT(x.is_valid());
+    EXPECT(255 == x.value_or_trap());
+  }
+  {
+    checked<i16> x{i64{70000}};
+    EXPECT(!x.is_valid());
+  }
+}
+
+void TestOperatorEqual() {
+  checked<i32> x{42};
+  checked<i32> y{42};
+  EXPECT(x == y);
+  EXPECT(!(x != y));
+  checked<i32> z = checked<i32>{numeric_limits<i32>::max()} + x;
+  EXPECT(!(z == z));
+  EXPECT(z != z);
+  EXPECT(z != x);
+}
+
+}  // namespace
+
+int main() {
+  TestArithmetic();
+  TestSigned();
+  TestConstructorU();
+  TestOperatorEqual();
+}
@@ -0,0 +1,219 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CHECKSUM_H_
+#define CHECKSUM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "span.h"
+#include "wrapping.h"
+
+namespace internal {
+
+// The most 16-bit words that a `uint32_t` can sum without wrapping:
+// 65537 * 0xFFFF = 2^32 - 1.
+constexpr size_t kOnesComplementChunk =
+    std::numeric_limits<uint32_t>::max() / 0xFFFF;
+
+// Returns the most terms, each at most `max_term`, that Fletcher-style sums
+// can accumulate in `uint32_t` before they must be reduced modulo `modulus`.
+//
+// From a first sum `a` and second sum `b`, both reduced (so at most
+// `modulus - 1`), n terms `x[i]` make the second sum
+//
+//   b + n * a + sum of (n - i) * x[i] <= (n + 1) * (modulus - 1) +
+//                                        max_term * n * (n + 1) / 2,
+//
+// and the first sum is smaller. So this is the largest n for which that
+// bound is at most `UINT32_MAX`.
+constexpr size_t deferred_modulo_terms(uint64_t max_term, uint64_t modulus) {
+  size_t n = 0;
+  while ((n + 2) * (modulus - 1) + max_term * (n + 1) * (n + 2) / 2 <=
+         std::numeric_limits<uint32_t>::max()) {
+    n++;
+  }
+  return n;
+}
+
+// zlib derives the same bound for Adler-32 (its `NMAX`).
+static_assert(deferred_modulo_terms(0xFF, 65521) == 5552);
+
+// Returns the one’s complement sum of the 16-bit words of `bytes`, in the
+// target’s byte order, unfolded. The last byte, if the size is odd, is
+// padded with 0.
+//
+// The words are summed in `uint32_t` chunks short enough never to wrap,
+// with no carries to propagate, so compilers vectorize the loop (widening
+// the words and adding them a vector at a time). End-around carries are
+// deferred to the final folding; that is correct because one’s complement
+// addition is associative.
+inline uint64_t ones_complement_words(const uint8_t* bytes, size_t size) {
+  const size_t count = size / 2;
+  uint64_t total = 0;
+  for (size_t start = 0; start < count; start += kOnesComplementChunk) {
+    const size_t end = start + std::min(kOnesComplementChunk, count - start);
+    integers::wrapping<uint32_t> partial{0u};
+    for (size_t i = start; i < end; i++) {
+      uint16_t word;
+      memcpy(&word, bytes + 2 * i, sizeof(word));
+      partial += integers::wrapping<uint32_t>{uint32_t{word}};
+    }
+    total += static_cast<uint32_t>(partial);
+  }
+  if (size % 2 != 0) {
+    uint16_t word = 0;
+    memcpy(&word, bytes + size - 1, 1);
+    total += word;
+  }
+  return total;
+}
+
+// Folds the carries out of the top of `sum` back into its low 16 bits.
+inline uint16_t fold_carries(uint64_t sum) {
+  while (sum > 0xFFFF) {
+    sum = (sum & 0xFFFF) + (sum >> 16);
+  }
+  return static_cast<uint16_t>(sum);
+}
+
+// Returns `word` converted between the target’s byte order and big-endian.
+inline uint16_t network_order(uint16_t word) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  return word;
+#else
+  return __builtin_bswap16(word);
+#endif
+}
+
+// Adds `terms` to the Fletcher-style sums `*first` and `*second` (which are
+// and stay reduced modulo `Modulus`).
+//
+// Within a chunk, the first sum gains the sum of the terms, and the second
+// sum gains `count * first` and the sum of each term weighted by the number
+// of terms from it to the end. Weights instead of a running sum leave the
+// loop without a dependency from one term to the next, so compilers
+// vectorize it, and `deferred_modulo_terms` proves that its wrapping
+// arithmetic never actually wraps.
+template <uint32_t Modulus, typename Term>
+void fletcher_sums(const Term* terms,
+                   size_t count,
+                   uint32_t* first,
+                   uint32_t* second) {
+  using W = integers::wrapping<uint32_t>;
+  constexpr size_t kChunk =
+      deferred_modulo_terms(std::numeric_limits<Term>::max(), Modulus);
+  uint32_t a = *first;
+  uint32_t b = *second;
+  for (size_t start = 0; start < count; start += kChunk) {
+    const uint32_t n = static_cast<uint32_t>(std::min(kChunk, count - start));
+    W sum{0u};
+    W weighted{0u};
+    for (uint32_t i = 0; i < n; i++) {
+      const W x{uint32_t{terms[start + i]}};
+      sum += x;
+      weighted += x * W{n - i};
+    }
+    b = (b + n * a + static_cast<uint32_t>(weighted)) % Modulus;
+    a = (a + static_cast<uint32_t>(sum)) % Modulus;
+  }
+  *first = a;
+  *second = b;
+}
+
+}  // namespace internal
+
+namespace integers {
+
+/// ## Checksums
+///
+/// These are the checksums of network and storage formats, whose definitions
+/// rely on wraparound in particular orders and on reductions modulo a prime
+/// or all 1s. They accumulate in `wrapping<uint32_t>` chunks of a length that
+/// is computed at compile time, from the widths of the terms and the
+/// accumulator, to be the longest for which the accumulation provably cannot
+/// wrap. So the reductions, or the folding of carries, happen once per chunk
+/// rather than once per term, and the inner loops have no branches, so
+/// compilers vectorize them for the target (e.g. with AVX2 or AVX-512 with
+/// `-march=native`).
+///
+/// ### `ones_complement_sum`
+///
+/// Returns the 16-bit one’s complement sum of `bytes`, as big-endian words
+/// (padding an odd last byte with 0), added to `initial`, as in RFC 1071.
+/// To continue a sum over more spans, pass it as `initial`; every span but
+/// the last must have an even size.
+inline uint16_t ones_complement_sum(span<const uint8_t> bytes,
+                                    uint16_t initial = 0) {
+  // Byte-swapping every word byte-swaps the one’s complement sum (RFC 1071
+  // section 2(B)), so the words are summed in the target’s byte order.
+  const uint64_t sum = internal::ones_complement_words(bytes.data(),
+                                                       bytes.size()) +
+                       internal::network_order(initial);
+  return internal::network_order(internal::fold_carries(sum));
+}
+
+/// ### `internet_checksum`
+///
+/// Returns the Internet checksum of `bytes`: the complement of their one’s
+/// complement sum (see `ones_complement_sum`), as in the headers of IPv4,
+/// ICMP, TCP, and UDP. Store it big-endian. A header with a correct checksum
+/// checksums to 0.
+inline uint16_t internet_checksum(span<const uint8_t> bytes,
+                                  uint16_t initial = 0) {
+  return static_cast<uint16_t>(~ones_complement_sum(bytes, initial));
+}
+
+/// ### `adler32`
+///
+/// Returns the Adler-32 checksum of `bytes`, as in zlib, continuing from the
+/// checksum `adler` of the bytes before them. (The checksum of no bytes is
+/// 1.)
+inline uint32_t adler32(span<const uint8_t> bytes, uint32_t adler = 1) {
+  uint32_t a = (adler & 0xFFFF) % 65521;
+  uint32_t b = (adler >> 16) % 65521;
+  internal::fletcher_sums<65521>(bytes.data(), bytes.size(), &a, &b);
+  return (b << 16) | a;
+}
+
+/// ### `fletcher16`
+///
+/// Returns the Fletcher-16 checksum of `bytes`: the second sum in the high
+/// byte, and the first in the low byte, both modulo 255.
+inline uint16_t fletcher16(span<const uint8_t> bytes) {
+  uint32_t a = 0;
+  uint32_t b = 0;
+  internal::fletcher_sums<255>(bytes.data(), bytes.size(), &a, &b);
+  return static_cast<uint16_t>((b << 8) | a);
+}
+
+/// ### `fletcher32`
+///
+/// Returns the Fletcher-32 checksum of `words`: the second sum in the high
+/// half, and the first in the low half, both modulo 65535.
+inline uint32_t fletcher32(span<const uint16_t> words) {
+  uint32_t a = 0;
+  uint32_t b = 0;
+  internal::fletcher_sums<65535>(words.data(), words.size(), &a, &b);
+  return (b << 16) | a;
+}
+
+}  // namespace integers
+
+#endif  // CHECKSUM_H_
@@ -0,0 +1,158 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "checksum.h"
+#include "test_support.h"
+
+using namespace integers;
+using namespace std;
+
+namespace {
+
+using u8 = uint8_t;
+using u16 = uint16_t;
+using u32 = uint32_t;
+using u64 = uint64_t;
+
+using Bytes = vector<u8>;
+
+Bytes FromString(const string& s) {
+  return Bytes(s.begin(), s.end());
+}
+
+// Reference implementations, a term at a time with a reduction per term.
+
+u16 ReferenceOnesComplementSum(const Bytes& bytes) {
+  u32 sum = 0;
+  for (size_t i = 0; i < bytes.size(); i += 2) {
+    const u32 low = i + 1 < bytes.size() ? bytes[i + 1] : 0;
+    sum += (u32{bytes[i]} << 8) | low;
+    sum = (sum & 0xFFFF) + (sum >> 16);
+  }
+  return static_cast<u16>(sum);
+}
+
+u32 ReferenceAdler32(const Bytes& bytes) {
+  u32 a = 1;
+  u32 b = 0;
+  for (const u8 byte : bytes) {
+    a = (a + byte) % 65521;
+    b = (b + a) % 65521;
+  }
+  return (b << 16) | a;
+}
+
+u16 ReferenceFletcher16(const Bytes& bytes) {
+  u32 a = 0;
+  u32 b = 0;
+  for (const u8 byte : bytes) {
+    a = (a + byte) % 255;
+    b = (b + a) % 255;
+  }
+  return static_cast<u16>((b << 8) | a);
+}
+
+u32 ReferenceFletcher32(const vector<u16>& words) {
+  u32 a = 0;
+  u32 b = 0;
+  for (const u16 word : words) {
+    a = (a + word) % 65535;
+    b = (b + a) % 65535;
+  }
+  return (b << 16) | a;
+}
+
+void TestKnownValues() {
+  // RFC 1071 section 3's example.
+  const Bytes rfc = {0x00, 0x01, 0xF2, 0x03, 0xF4, 0xF5, 0xF6, 0xF7};
+  EXPECT(0xDDF2 == ones_complement_sum(rfc));
+  EXPECT(0x220D == internet_checksum(rfc));
+
+  // An IPv4 header, whose checksum (0xB861, at offset 10) verifies to 0.
+  Bytes header = {0x45, 0x00, 0x00, 0x73, 0x00, 0x00, 0x40, 0x00, 0x40, 0x11,
+                  0x00, 0x00, 0xC0, 0xA8, 0x00, 0x01, 0xC0, 0xA8, 0x00, 0xC7};
+  EXPECT(0xB861 == internet_checksum(header));
+  header[10] = 0xB8;
+  header[11] = 0x61;
+  EXPECT(0 == internet_checksum(header));
+
+  EXPECT(1 == adler32(Bytes{}));
+  EXPECT(0x11E60398 == adler32(FromString("Wikipedia")));
+  EXPECT(0x90860B20 == adler32(FromString("abcdefghijklmnopqrstuvwxyz")));
+
+  EXPECT(0x0000 == fletcher16(Bytes{}));
+  EXPECT(0xC8F0 == fletcher16(FromString("abcde")));
+  EXPECT(0x2057 == fletcher16(FromString("abcdef")));
+  EXPECT(0x0627 == fletcher16(FromString("abcdefgh")));
+
+  // "abcde" and "abcdefgh" as little-endian 16-bit words, "e" padded.
+  EXPECT(0xF04FC729 == fletcher32(vector<u16>{0x6261, 0x6463, 0x0065}));
+  EXPECT(0xEBE19591 ==
+         fletcher32(vector<u16>{0x6261, 0x6463, 0x6665, 0x6867}));
+}
+
+// Inputs of all 0xFF bytes maximize every sum, so they overflow first if a
+// chunk is too long. Check well past the longest chunk, against references
+// that reduce after every term.
+void TestAgainstReferences() {
+  for (const size_t size :
+       {size_t{0}, size_t{1}, size_t{2}, size_t{3}, size_t{31}, size_t{5552},
+        size_t{5553}, size_t{11105}, size_t{2 * 65537 + 3}, size_t{300001}}) {
+    for (const u8 fill : {u8{0xFF}, u8{0x5A}}) {
+      Bytes bytes(size, fill);
+      for (size_t i = 0; i < size; i += 7) {
+        bytes[i] = static_cast<u8>(i);
+      }
+      EXPECT(ReferenceOnesComplementSum(bytes) == ones_complement_sum(bytes));
+      EXPECT(ReferenceAdler32(bytes) == adler32(bytes));
+      EXPECT(ReferenceFletcher16(bytes) == fletcher16(bytes));
+
+      vector<u16> words(size, static_cast<u16>(fill * 0x101));
+      for (size_t i = 0; i < size; i += 5) {
+        words[i] = static_cast<u16>(i * 31);
+      }
+      EXPECT(ReferenceFletcher32(words) == fletcher32(words));
+    }
+  }
+}
+
+void TestIncremental() {
+  Bytes bytes(100000);
+  for (size_t i = 0; i < bytes.size(); i++) {
+    bytes[i] = static_cast<u8>(i * 131 + 7);
+  }
+  const span<const u8> all(bytes);
+  for (const size_t split :
+       {size_t{0}, size_t{2}, size_t{5552}, size_t{77778}}) {
+    EXPECT(adler32(all) ==
+           adler32(all.subspan(split), adler32(all.first(split))));
+    EXPECT(ones_complement_sum(all) ==
+           ones_complement_sum(all.subspan(split),
+                               ones_complement_sum(all.first(split))));
+  }
+  EXPECT(adler32(all) == adler32(all.subspan(3), adler32(all.first(3))));
+}
+
+}  // namespace
+
+int main() {
+  TestKnownValues();
+  TestAgainstReferences();
+  TestIncremental();
+}
@@ -12,27 +12,305 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#ifndef INTEGERS_H_
-#define INTEGERS_H_
+#ifndef CLAMPING_H_
+#define CLAMPING_H_
 
 #include <stdint.h>
 #include <stdlib.h>
 
 #include <algorithm>
 #include <limits>
+#include <ostream>
 #include <type_traits>
 
 #include "is_integral.h"
+#include "span.h"
+#include "trapping.h"
+#include "wide.h"
+
+namespace internal {
+
+template <typename T>
+constexpr bool is_negative(T x) {
+  if constexpr (std::is_signed_v<T>) {
+    return x < 0;
+  } else {
+    return false;
+  }
+}
+
+// Returns true if the mathematical value of `x` is less than that of `y`. (A
+// polyfill of C++20 `std::cmp_less`.)
+template <typename T, typename U>
+constexpr bool cmp_less(T x, U y) {
+  if constexpr (std::is_signed_v<T> == std::is_signed_v<U>) {
+    return x < y;
+  } else if constexpr (std::is_signed_v<T>) {
+    return x < 0 || std::make_unsigned_t<T>(x) < y;
+  } else {
+    return y >= 0 && x < std::make_unsigned_t<U>(y);
+  }
+}
+
+// Returns true if the mathematical value of `x + y` is negative.
+template <typename T, typename U>
+constexpr bool sum_is_negative(T x, U y) {
+  if (is_negative(x) == is_negative(y)) {
+    return is_negative(x);
+  }
+  // The magnitude of the negative operand, computed without overflow.
+  const uint64_t negative = is_negative(x) ? uint64_t{0} - uint64_t(x)
+                                           : uint64_t{0} - uint64_t(y);
+  const uint64_t positive = is_negative(x) ? uint64_t(y) : uint64_t(x);
+  return positive < negative;
+}
+
+// The same-type operations below are written with plain arithmetic and
+// selects, rather than branches, so that compilers can vectorize loops of
+// them. For lanes narrower than 32 bits, they compute in a wider type and
+// clamp. Clang can recognize that as saturating arithmetic (e.g. x86’s
+// `paddusb` and `paddsw`); GCC (as of version 12) instead vectorizes it as
+// widen, clamp, and pack. For wider lanes, they compute the wrapped result,
+// check for overflow, and select the limit instead (compare-and-blend).
+
+template <typename T>
+constexpr T clamp_wide(int32_t x) {
+  return static_cast<T>(std::clamp<int32_t>(x, std::numeric_limits<T>::min(),
+                                            std::numeric_limits<T>::max()));
+}
+
+template <typename T>
+T saturating_add(T x, T y) {
+  if constexpr (sizeof(T) < sizeof(int32_t)) {
+    return clamp_wide<T>(int32_t{x} + int32_t{y});
+  } else {
+    T result;
+    const bool overflow = vector_add_overflow(x, y, &result);
+    const T limit = is_negative(x) ? std::numeric_limits<T>::min()
+                                   : std::numeric_limits<T>::max();
+    return overflow ? limit : result;
+  }
+}
+
+template <typename T>
+T saturating_sub(T x, T y) {
+  if constexpr (sizeof(T) < sizeof(int32_t)) {
+    return clamp_wide<T>(int32_t{x} - int32_t{y});
+  } else {
+    T result;
+    const bool overflow = vector_sub_overflow(x, y, &result);
+    // Signed subtraction overflows toward `x`’s sign; unsigned, only down.
+    const T limit = std::is_signed_v<T> && !is_negative(x)
+                        ? std::numeric_limits<T>::max()
+                        : std::numeric_limits<T>::min();
+    return overflow ? limit : result;
+  }
+}
+
+template <typename T>
+T saturating_mul(T x, T y) {
+  T result;
+  const bool overflow = vector_mul_overflow(x, y, &result);
+  const T limit = is_negative(x) != is_negative(y)
+                      ? std::numeric_limits<T>::min()
+                      : std::numeric_limits<T>::max();
+  return overflow ? limit : result;
+}
+
+}  // namespace internal
 
 namespace integers {
 
 /// ## Clamping Operations
+///
+/// ### `clamping_cast`
+///
+/// Converts `T`s to `R`s. If `R` cannot hold the full `value`, returns the
+/// nearest value that `R` can hold (i.e. `R`’s minimum or maximum).
+template <typename R, typename T>
+constexpr R clamping_cast(T value) {
+  assert_is_integral(R);
+  assert_is_integral(T);
 
-// TODO
+  // The part of `R`’s range that `T` can represent. Clamping to it, rather
+  // than branching on `in_range`, lets compilers vectorize loops of this
+  // function (as e.g. x86’s `vpmovs*` and `packssdw`).
+  using T_limits = std::numeric_limits<T>;
+  using R_limits = std::numeric_limits<R>;
+  constexpr T kLowest = internal::cmp_less(T_limits::min(), R_limits::min())
+                            ? static_cast<T>(R_limits::min())
+                            : T_limits::min();
+  constexpr T kHighest = internal::cmp_less(R_limits::max(), T_limits::max())
+                             ? static_cast<T>(R_limits::max())
+                             : T_limits::max();
+  return static_cast<R>(std::clamp(value, kLowest, kHighest));
+}
+
+/// ### `clamping_add`
+///
+/// Adds `x` and `y` and returns the result. If `R` cannot represent the
+/// result, returns `R`’s minimum or maximum, whichever is nearest.
+template <typename R, typename T, typename U>
+R clamping_add(T x, U y) {
+  assert_is_integral(R);
+  assert_is_integral(T);
+  assert_is_integral(U);
+
+  if constexpr (std::is_same_v<T, R> && std::is_same_v<U, R>) {
+    return internal::saturating_add(x, y);
+  } else {
+    R result = 0;
+    if (add_overflow(x, y, &result)) {
+      result = internal::sum_is_negative(x, y) ? std::numeric_limits<R>::min()
+                                               : std::numeric_limits<R>::max();
+    }
+    return result;
+  }
+}
+
+/// ### `clamping_sub`
+///
+/// Subtracts `y` from `x` and returns the result. If `R` cannot represent the
+/// result, returns `R`’s minimum or maximum, whichever is nearest.
+template <typename R, typename T, typename U>
+R clamping_sub(T x, U y) {
+  assert_is_integral(R);
+  assert_is_integral(T);
+  assert_is_integral(U);
+
+  if constexpr (std::is_same_v<T, R> && std::is_same_v<U, R>) {
+    return internal::saturating_sub(x, y);
+  } else {
+    R result = 0;
+    if (sub_overflow(x, y, &result)) {
+      result = internal::cmp_less(x, y) ? std::numeric_limits<R>::min()
+                                        : std::numeric_limits<R>::max();
+    }
+    return result;
+  }
+}
+
+/// ### `clamping_mul`
+///
+/// Multiplies `x` and `y` and returns the result. If `R` cannot represent the
+/// result, returns `R`’s minimum or maximum, whichever is nearest.
+template <typename R, typename T, typename U>
+R clamping_mul(T x, U y) {
+  assert_is_integral(R);
+  assert_is_integral(T);
+  assert_is_integral(U);
+
+  if constexpr (std::is_same_v<T, R> && std::is_same_v<U, R>) {
+    return internal::saturating_mul(x, y);
+  } else {
+    R result = 0;
+    if (mul_overflow(x, y, &result)) {
+      result = internal::is_negative(x) != internal::is_negative(y)
+                   ? std::numeric_limits<R>::min()
+                   : std::numeric_limits<R>::max();
+    }
+    return result;
+  }
+}
+
+/// ### `clamping_div`
+///
+/// Divides `dividend` by `divisor` and returns the quotient. If `R` cannot
+/// represent the quotient (e.g. for the minimum value divided by -1), returns
+/// `R`’s minimum or maximum, whichever is nearest. There is no nearest value
+/// to a quotient by 0, so if `divisor` is 0, this function will `trap`.
+template <typename R, typename T, typename U>
+R clamping_div(T dividend, U divisor) {
+  assert_is_integral(R);
+  assert_is_integral(T);
+  assert_is_integral(U);
+
+  if (divisor == 0) {
+    trap();
+  }
+  R result = 0;
+  if (div_overflow(dividend, divisor, &result)) {
+    result = internal::is_negative(dividend) != internal::is_negative(divisor)
+                 ? std::numeric_limits<R>::min()
+                 : std::numeric_limits<R>::max();
+  }
+  return result;
+}
+
+/// ### `clamping_mod`
+///
+/// Divides `dividend` by `divisor` and returns the remainder. If `R` cannot
+/// represent the remainder, returns `R`’s minimum or maximum, whichever is
+/// nearest. (The remainder of the minimum value divided by -1 is 0.) If
+/// `divisor` is 0, this function will `trap`.
+template <typename R, typename T, typename U>
+R clamping_mod(T dividend, U divisor) {
+  assert_is_integral(R);
+  assert_is_integral(T);
+  assert_is_integral(U);
+
+  if (divisor == 0) {
+    trap();
+  }
+  if constexpr (std::is_signed_v<T> && std::is_signed_v<U>) {
+    if (divisor == -1) {
+      return 0;
+    }
+  }
+  R result = 0;
+  if (mod_overflow(dividend, divisor, &result)) {
+    result = internal::is_negative(dividend) ? std::numeric_limits<R>::min()
+                                             : std::numeric_limits<R>::max();
+  }
+  return result;
+}
+
+/// ### `clamping_mul_high`
+///
+/// Multiplies `x` and `y` as fixed-point fractions and returns the rounded
+/// result. Unsigned `T`s represent `x / 2**bits` (so that e.g. a `uint8_t`
+/// alpha of 255 is nearly 1.0), and signed `T`s `x / 2**(bits - 1)` (Q15, for
+/// `int16_t` audio samples). The only product that `T` cannot represent is
+/// -1.0 * -1.0, which clamps to `T`’s maximum.
+///
+/// On x86, the 16-bit signed form is `pmulhrsw`.
+template <typename T>
+T clamping_mul_high(T x, T y) {
+  assert_is_integral(T);
+
+  constexpr int kBits = std::numeric_limits<T>::digits;
+  using W =
+      internal::wide_integer_t<2 * (kBits + std::is_signed_v<T>),
+                               std::is_signed_v<T>>;
+  const W product = static_cast<W>(static_cast<W>(x) * static_cast<W>(y) +
+                                   (W{1} << (kBits - 1)));
+  // `digits` excludes the sign bit, so this shifts by `bits - 1` for signed
+  // `T`s and by `bits` for unsigned.
+  return internal::wide_clamp<T>(product >> kBits);
+}
+
+/// ### `clamping_average`
+///
+/// Returns the average of `x` and `y`, rounded up. This never overflows, but
+/// belongs with the other clamping operations for pixel and sample data.
+///
+/// On x86, the 8- and 16-bit unsigned forms are `pavgb` and `pavgw`.
+template <typename T>
+T clamping_average(T x, T y) {
+  assert_is_integral(T);
+
+  using W = internal::wide_integer_t<std::numeric_limits<T>::digits + 2,
+                                     std::is_signed_v<T>>;
+  return static_cast<T>((static_cast<W>(x) + static_cast<W>(y) + 1) >> 1);
+}
 
 /// ## `clamping<T>`
 ///
-/// TODO: Documentation.
+/// This template class implements integer types that saturate: results that
+/// `T` cannot represent become `T`’s minimum or maximum value.
+///
+/// For guaranteed trapping behavior, see the companion template class
+/// `trapping<T>`.
 template <typename T>
 class clamping {
   assert_is_integral(T);
@@ -40,10 +318,375 @@ class clamping {
   using Self = clamping<T>;
 
  public:
+  /// ### `clamping`
+  ///
+  /// The default constructor. The contents of the object are undefined. 😕
+  /// Best practice is to use `-ftrivial-auto-var-init=zero` or to
+  /// explicitly initialize the object.
+  clamping() = default;
+
+  /// ### `clamping`
+  ///
+  /// Constructs and initializes.
+  template <typename U, std::enable_if_t<std::is_same_v<T, U>, int> = 0>
+  clamping(U value) : value_(value) {}
+
+  /// ### `clamping`
+  ///
+  /// Constructs and initializes. If `T` cannot represent `value`, clamps it to
+  /// `T`’s minimum or maximum.
+  template <typename U, std::enable_if_t<!std::is_same_v<T, U>, int> = 0>
+  explicit clamping(U value) : value_(clamping_cast<T>(value)) {}
+
+  /// ### `operator+=`
+  ///
+  /// Increments by `x`, clamping on overflow.
+  Self& operator+=(Self x) {
+    value_ = clamping_add<T, T, T>(value_, x.value_);
+    return *this;
+  }
+
+  /// ### `operator+`
+  ///
+  /// Adds `rhs` to `lhs`, assigns the result to `lhs`, and returns it.
+  /// Clamps on overflow.
+  friend Self operator+(Self lhs, Self rhs) {
+    lhs += rhs;
+    return lhs;
+  }
+
+  /// ### `operator+`
+  ///
+  /// Adds `rhs` to `lhs`, assigns the result to `lhs`, and returns it.
+  /// Clamps on overflow.
+  template <typename U>
+  friend Self operator+(Self lhs, U rhs) {
+    lhs += Self{rhs};
+    return lhs;
+  }
+
+  /// ### `operator+`
+  ///
+  /// Adds `rhs` to `lhs`, assigns the result to `lhs`, and returns it.
+  /// Clamps on overflow.
+  template <typename U>
+  friend Self operator+(U lhs, Self rhs) {
+    Self result{lhs};
+    result += rhs;
+    return result;
+  }
+
+  /// ### `operator-=`
+  ///
+  /// Subtracts `x`, clamping on overflow.
+  Self& operator-=(Self x) {
+    value_ = clamping_sub<T, T, T>(value_, x.value_);
+    return *this;
+  }
+
+  /// ### `operator-`
+  ///
+  /// Subtracts `rhs` from `lhs`, assigns the result to `lhs`, and returns
+  /// it. Clamps on overflow.
+  friend Self operator-(Self lhs, Self rhs) {
+    lhs -= rhs;
+    return lhs;
+  }
+
+  /// ### `operator-`
+  ///
+  /// Subtracts `rhs` from `lhs`, assigns the result to `lhs`, and returns
+  /// it. Clamps on overflow.
+  template <typename U>
+  friend Self operator-(Self lhs, U rhs) {
+    lhs -= Self{rhs};
+    return lhs;
+  }
+
+  /// ### `operator-`
+  ///
+  /// Subtracts `rhs` from `lhs`, assigns the result to `lhs`, and returns
+  /// it. Clamps on overflow.
+  template <typename U>
+  friend Self operator-(U lhs, Self rhs) {
+    Self result{lhs};
+    result -= rhs;
+    return result;
+  }
+
+  /// ### `operator*=`
+  ///
+  /// Multiplies by `x`, clamping on overflow.
+  Self& operator*=(Self x) {
+    value_ = clamping_mul<T, T, T>(value_, x.value_);
+    return *this;
+  }
+
+  /// ### `operator*`
+  ///
+  /// Multiplies `lhs` by `rhs`, assigns the result to `lhs`, and returns
+  /// it. Clamps on overflow.
+  friend Self operator*(Self lhs, Self rhs) {
+    lhs *= rhs;
+    return lhs;
+  }
+
+  /// ### `operator*`
+  ///
+  /// Multiplies `lhs` by `rhs`, assigns the result to `lhs`, and returns
+  /// it. Clamps on overflow.
+  template <typename U>
+  friend Self operator*(Self lhs, U rhs) {
+    lhs *= Self{rhs};
+    return lhs;
+  }
+
+  /// ### `operator*`
+  ///
+  /// Multiplies `lhs` by `rhs`, assigns the result to `lhs`, and returns
+  /// it. Clamps on overflow.
+  template <typename U>
+  friend Self operator*(U lhs, Self rhs) {
+    Self result{lhs};
+    result *= rhs;
+    return result;
+  }
+
+  /// ### `operator/=`
+  ///
+  /// Divides by `divisor`, storing the quotient in `*this`, and clamping on
+  /// overflow. `trap`s if `divisor` is 0.
+  Self& operator/=(Self divisor) {
+    value_ = clamping_div<T, T, T>(value_, divisor.value_);
+    return *this;
+  }
+
+  /// ### `operator/`
+  ///
+  /// Divides `dividend` by `divisor`, storing the quotient in `dividend`, and
+  /// returns `dividend`. Clamps on overflow, and `trap`s if `divisor` is 0.
+  friend Self operator/(Self dividend, Self divisor) {
+    dividend /= divisor;
+    return dividend;
+  }
+
+  /// ### `operator/`
+  ///
+  /// Divides `dividend` by `divisor`, storing the quotient in `dividend`, and
+  /// returns `dividend`. Clamps on overflow, and `trap`s if `divisor` is 0.
+  template <typename U>
+  friend Self operator/(Self dividend, U divisor) {
+    dividend /= Self{divisor};
+    return dividend;
+  }
+
+  /// ### `operator/`
+  ///
+  /// Divides `dividend` by `divisor`, storing the quotient in `dividend`, and
+  /// returns `dividend`. Clamps on overflow, and `trap`s if `divisor` is 0.
+  template <typename U>
+  friend Self operator/(U dividend, Self divisor) {
+    Self result{dividend};
+    result /= divisor;
+    return result;
+  }
+
+  /// ### `operator%=`
+  ///
+  /// Divides by `divisor`, storing the remainder in `*this`. `trap`s if
+  /// `divisor` is 0.
+  Self& operator%=(Self divisor) {
+    value_ = clamping_mod<T, T, T>(value_, divisor.value_);
+    return *this;
+  }
+
+  /// ### `operator%`
+  ///
+  /// Divides `dividend` by `divisor`, storing the remainder in `dividend`, and
+  /// returns `dividend`. `trap`s if `divisor` is 0.
+  friend Self operator%(Self dividend, Self divisor) {
+    dividend %= divisor;
+    return dividend;
+  }
+
+  /// ### `operator%`
+  ///
+  /// Divides `dividend` by `divisor`, storing the remainder in `dividend`, and
+  /// returns `dividend`. `trap`s if `divisor` is 0.
+  template <typename U>
+  friend Self operator%(Self dividend, U divisor) {
+    dividend %= Self{divisor};
+    return dividend;
+  }
+
+  /// ### `operator%`
+  ///
+  /// Divides `dividend` by `divisor`, storing the remainder in `dividend`, and
+  /// returns `dividend`. `trap`s if `divisor` is 0.
+  template <typename U>
+  friend Self operator%(U dividend, Self divisor) {
+    Self result{dividend};
+    result %= divisor;
+    return result;
+  }
+
+  /// ### `operator+`
+  ///
+  /// Does nothing. (But it’s explicit about it!)
+  Self operator+() const { return *this; }
+
+  /// ### `operator-`
+  ///
+  /// Returns the value with its sign reversed. If `T` is signed and the value
+  /// is the minimum, whose negation `T` cannot represent, returns `T`’s
+  /// maximum. (For unsigned `T`s, which cannot represent any negative value,
+  /// returns 0.)
+  Self operator-() const { return Self{clamping_sub<T, T, T>(T{0}, value_)}; }
+
+  /// ### `operator++`
+  ///
+  /// Prefix increment. Increments the value, clamping, and returns `*this`
+  /// with the new value.
+  Self& operator++() {
+    *this += Self{T{1}};
+    return *this;
+  }
+
+  /// ### `operator++`
+  ///
+  /// Postfix increment. Increments the value, clamping, and returns an object
+  /// containing the previous value.
+  Self operator++(int) {
+    Self previous = *this;
+    ++*this;
+    return previous;
+  }
+
+  /// ### `operator--`
+  ///
+  /// Prefix decrement. Decrements the value, clamping, and returns `*this`
+  /// with the new value.
+  Self& operator--() {
+    *this -= Self{T{1}};
+    return *this;
+  }
+
+  /// ### `operator--`
+  ///
+  /// Postfix decrement. Decrements the value, clamping, and returns an object
+  /// containing the previous value.
+  Self operator--(int) {
+    Self previous = *this;
+    --*this;
+    return previous;
+  }
+
+  /// ### `operator==`
+  ///
+  /// Returns true if `lhs` and `rhs` are equal.
+  friend bool operator==(Self lhs, Self rhs) {
+    return lhs.value_ == rhs.value_;
+  }
+
+  /// ### `operator!=`
+  ///
+  /// Returns true if `lhs` and `rhs` are not equal.
+  friend bool operator!=(Self lhs, Self rhs) { return !(lhs == rhs); }
+
+  /// ### `operator<`
+  ///
+  /// Returns true if `lhs` is less than `rhs`.
+  friend bool operator<(Self lhs, Self rhs) { return lhs.value_ < rhs.value_; }
+
+  /// ### `operator<`
+  ///
+  /// Returns true if `lhs` is less than `rhs`.
+  friend bool operator<(Self lhs, T rhs) { return lhs.value_ < rhs; }
+
+  /// ### `operator<`
+  ///
+  /// Returns true if `lhs` is less than `rhs`.
+  friend bool operator<(T lhs, Self rhs) { return lhs < rhs.value_; }
+
+  /// ### `operator>`
+  ///
+  /// Returns true if `lhs` is greater than `rhs`.
+  friend bool operator>(Self lhs, Self rhs) { return rhs < lhs; }
+
+  /// ### `operator>`
+  ///
+  /// Returns true if `lhs` is greater than `rhs`.
+  friend bool operator>(Self lhs, T rhs) { return rhs < lhs; }
+
+  /// ### `operator>`
+  ///
+  /// Returns true if `lhs` is greater than `rhs`.
+  friend bool operator>(T lhs, Self rhs) { return rhs < lhs; }
+
+  /// ### `operator<=`
+  ///
+  /// Returns true if `lhs` is less than or equal to `rhs`.
+  friend bool operator<=(Self lhs, Self rhs) { return !(lhs > rhs); }
+
+  /// ### `operator<=`
+  ///
+  /// Returns true if `lhs` is less than or equal to `rhs`.
+  friend bool operator<=(Self lhs, T rhs) { return !(lhs > rhs); }
+
+  /// ### `operator<=`
+  ///
+  /// Returns true if `lhs` is less than or equal to `rhs`.
+  friend bool operator<=(T lhs, Self rhs) { return !(lhs > rhs); }
+
+  /// ### `operator>=`
+  ///
+  /// Returns true if `lhs` is greater than or equal to `rhs`.
+  friend bool operator>=(Self lhs, Self rhs) { return !(lhs < rhs); }
+
+  /// ### `operator>=`
+  ///
+  /// Returns true if `lhs` is greater than or equal to `rhs`.
+  friend bool operator>=(Self lhs, T rhs) { return !(lhs < rhs); }
+
+  /// ### `operator>=`
+  ///
+  /// Returns true if `lhs` is greater than or equal to `rhs`.
+  friend bool operator>=(T lhs, Self rhs) { return !(lhs < rhs); }
+
+  /// ### `operator<<`
+  ///
+  /// Writes `self`'s value to the `ostream`, and returns the `ostream`.
+  friend std::ostream& operator<<(std::ostream& os, Self self) {
+    os << self.value_;
+    return os;
+  }
+
+  /// ### `abs`
+  ///
+  /// Returns the absolute value of `x`. If `T` cannot represent it (for the
+  /// minimum value of a signed `T`), returns `T`’s maximum.
+  friend Self abs(Self x) {
+    if constexpr (std::is_unsigned_v<T>) {
+      return x;
+    } else {
+      return x < T{0} ? -x : x;
+    }
+  }
+
+  /// ### `operator U`
+  ///
+  /// Returns the plain `T` value as a `U`, clamped to `U`’s range.
+  template <typename U>
+  operator U() const {
+    return clamping_cast<U>(value_);
+  }
+
  private:
   T value_;
 };
 
+static_assert(std::is_trivial_v<clamping<int>>,
+              "`clamping<T>` must be trivial");
 static_assert(sizeof(clamping<int8_t>) == sizeof(int8_t),
               "sizeof(clamping<int8_t>) must == sizeof(int8_t)");
 static_assert(sizeof(clamping<int16_t>) == sizeof(int16_t),
@@ -53,6 +696,33 @@ static_assert(sizeof(clamping<int32_t>) == sizeof(int32_t),
 static_assert(sizeof(clamping<int64_t>) == sizeof(int64_t),
               "sizeof(clamping<int64_t>) must == sizeof(int64_t)");
 
+/// ### `as_clamping`
+///
+/// Returns a view of `values` as `clamping<T>`s, without copying. See
+/// `as_trapping`.
+template <typename T>
+span<internal::rewrapped_t<clamping, T>> as_clamping(span<T> values) {
+  return internal::span_cast<internal::rewrapped_t<clamping, T>>(values);
+}
+
+/// ### `as_underlying`
+///
+/// Returns a view of `values` as plain `T`s, without copying. The inverse of
+/// `as_clamping`.
+template <typename T>
+span<T> as_underlying(span<clamping<T>> values) {
+  return internal::span_cast<T>(values);
+}
+
+/// ### `as_underlying`
+///
+/// Returns a view of `values` as plain `T`s, without copying. The inverse of
+/// `as_clamping`.
+template <typename T>
+span<const T> as_underlying(span<const clamping<T>> values) {
+  return internal::span_cast<const T>(values);
+}
+
 }  // namespace integers
 
-#endif  // INTEGERS_H_
+#endif  // CLAMPING_H_
@@ -14,6 +14,7 @@
 
 #include <iostream>
 #include <limits>
+#include <vector>
 
 #include "clamping.h"
 #include "test_support.h"
@@ -21,4 +22,227 @@
 using namespace integers;
 using namespace std;
 
-int main() {}
+namespace {
+
+using i8 = int8_t;
+using u8 = uint8_t;
+using i16 = int16_t;
+using u16 = uint16_t;
+using i32 = int32_t;
+using u32 = uint32_t;
+using i64 = int64_t;
+using u64 = uint64_t;
+
+void TestClampingCast() {
+  EXPECT(127 == (clamping_cast<i8>(i32{1000})));
+  EXPECT(-128 == (clamping_cast<i8>(i32{-1000})));
+  EXPECT(42 == (clamping_cast<i8>(i32{42})));
+  EXPECT(0 == (clamping_cast<u8>(i32{-1})));
+  EXPECT(255 == (clamping_cast<u8>(u64{256})));
+  EXPECT(0 == (clamping_cast<u32>(numeric_limits<i64>::min())));
+  EXPECT(numeric_limits<i64>::max() ==
+         (clamping_cast<i64>(numeric_limits<u64>::max())));
+  EXPECT(numeric_limits<u32>::max() ==
+         (clamping_cast<u32>(numeric_limits<u32>::max())));
+}
+
+template <typename R, typename T>
+void TestClampingCastPair() {
+  constexpr T max = numeric_limits<T>::max();
+  constexpr T min = numeric_limits<T>::min();
+  const T values[] = {min, static_cast<T>(min + 1), static_cast<T>(-1), 0, 1,
+                      static_cast<T>(max - 1), max};
+  for (const T x : values) {
+    R expected = 0;
+    if (integers::in_range<R>(x)) {
+      expected = static_cast<R>(x);
+    } else if (x < 0) {
+      expected = numeric_limits<R>::min();
+    } else {
+      expected = numeric_limits<R>::max();
+    }
+    EXPECT(expected == clamping_cast<R>(x));
+  }
+}
+
+template <typename R, typename... T>
+void CallTestClampingCastPair() {
+  (TestClampingCastPair<R, T>(), ...);
+}
+
+template <typename... R>
+void CallTestClampingCastPairs() {
+  (CallTestClampingCastPair<R, i8, u8, i16, u16, i32, u32, i64, u64>(), ...);
+}
+
+void TestClampingCastAllTypes() {
+  CallTestClampingCastPairs<i8, u8, i16, u16, i32, u32, i64, u64>();
+}
+
+void TestConstructorT() {
+  {
+    clamping<i8> x{i32{1000}};
+    EXPECT(127 == static_cast<i8>(x));
+  }
+  {
+    clamping<u8> x{i32{-1}};
+    EXPECT(0 == static_cast<u8>(x));
+  }
+  {
+    clamping<i32> x{-1};
+    EXPECT(0 == static_cast<u32>(x));
+    EXPECT(-1 == static_cast<i64>(x));
+  }
+}
+
+template <typename T>
+void GenericTestClampingArithmetic() {
+  constexpr T max = numeric_limits<T>::max();
+  constexpr T min = numeric_limits<T>::min();
+
+  EXPECT(T{7} == (clamping_add<T, T, T>(3, 4)));
+  EXPECT(max == (clamping_add<T, T, T>(max, 1)));
+  EXPECT(max == (clamping_add<T, T, T>(max, max)));
+  EXPECT(T{3} == (clamping_sub<T, T, T>(7, 4)));
+  EXPECT(min == (clamping_sub<T, T, T>(min, 1)));
+  EXPECT(T{12} == (clamping_mul<T, T, T>(3, 4)));
+  EXPECT(max == (clamping_mul<T, T, T>(max, 2)));
+  if constexpr (is_signed_v<T>) {
+    EXPECT(min == (clamping_add<T, T, T>(min, -1)));
+    EXPECT(min == (clamping_add<T, T, T>(min, min)));
+    EXPECT(max == (clamping_sub<T, T, T>(max, -1)));
+    EXPECT(max == (clamping_sub<T, T, T>(0, min)));
+    EXPECT(min == (clamping_sub<T, T, T>(-2, max)));
+    EXPECT(min == (clamping_mul<T, T, T>(max, -2)));
+    EXPECT(max == (clamping_mul<T, T, T>(min, -1)));
+    EXPECT(max == (clamping_mul<T, T, T>(min, min)));
+  } else {
+    EXPECT(min == (clamping_sub<T, T, T>(3, 4)));
+  }
+
+  // Fractions: 1/2 * 1/2 == 1/4, and (nearly) 1 * (nearly) 1.
+  constexpr T half = T{1} << (numeric_limits<T>::digits - 1);
+  EXPECT(half / 2 == clamping_mul_high<T>(half, half));
+  EXPECT(max - 1 == clamping_mul_high<T>(max, max));
+  if constexpr (is_signed_v<T>) {
+    EXPECT(max == clamping_mul_high<T>(min, min));
+    EXPECT(-half / 2 == clamping_mul_high<T>(-half, half));
+  }
+
+  EXPECT(T{4} == clamping_average<T>(3, 4));
+  EXPECT(max == clamping_average<T>(max, max));
+  EXPECT(min == clamping_average<T>(min, min));
+  EXPECT(T{max / 2 + 1} == clamping_average<T>(max, 1));
+  if constexpr (is_signed_v<T>) {
+    EXPECT(T{0} == clamping_average<T>(min, max));
+    EXPECT(T{-1} == clamping_average<T>(-3, 0));
+  }
+
+  clamping<T> x{max};
+  x += clamping<T>{T{1}};
+  EXPECT(max == x);
+  EXPECT(max == x * T{2});
+  EXPECT(min == clamping<T>{min} - T{1});
+  EXPECT(T{5} == clamping<T>{T{2}} + clamping<T>{T{3}});
+  EXPECT(clamping<T>{T{2}} < clamping<T>{T{3}});
+  EXPECT(clamping<T>{T{2}} != clamping<T>{T{3}});
+
+  const clamping<T> two{T{2}};
+  const clamping<T> three{T{3}};
+  EXPECT(three > two && three >= two && two <= three && !(two >= three));
+  EXPECT(two <= two && two >= two && !(two > two));
+  EXPECT(two < T{3} && T{3} > two && two <= T{2} && T{2} >= two);
+
+  EXPECT(T{3} == clamping<T>{T{7}} / two);
+  EXPECT(T{1} == clamping<T>{T{7}} % two);
+  EXPECT(T{3} == clamping<T>{T{7}} / T{2});
+  EXPECT(T{1} == T{7} % two);
+  clamping<T> y{T{7}};
+  y /= three;
+  EXPECT(T{2} == y);
+  y %= two;
+  EXPECT(T{0} == y);
+  EXPECT_DEATH(y / clamping<T>{T{0}});
+  EXPECT_DEATH(y % clamping<T>{T{0}});
+
+  clamping<T> z{max};
+  EXPECT(max == z++);
+  EXPECT(max == ++z);
+  z = clamping<T>{min};
+  EXPECT(min == z--);
+  EXPECT(min == --z);
+  EXPECT(T{3} == +three);
+  EXPECT(T{3} == abs(three));
+
+  if constexpr (is_signed_v<T>) {
+    EXPECT(max == (clamping_div<T, T, T>(min, -1)));
+    EXPECT(T{0} == (clamping_mod<T, T, T>(min, -1)));
+    EXPECT(T{-3} == -three);
+    EXPECT(max == -clamping<T>{min});
+    EXPECT(max == abs(clamping<T>{min}));
+    EXPECT(T{3} == abs(-three));
+    EXPECT(T{-3} == clamping<T>{T{-7}} / two);
+    EXPECT(T{-1} == clamping<T>{T{-7}} % two);
+  } else {
+    EXPECT(T{0} == -three);
+  }
+}
+
+template <class... T>
+void CallGenericTestClampingArithmetic() {
+  (GenericTestClampingArithmetic<T>(), ...);
+}
+
+void TestClampingArithmetic() {
+  CallGenericTestClampingArithmetic<i8, u8, i16, u16, i32, u32, i64, u64>();
+}
+
+void TestClampingMixedTypes() {
+  EXPECT(127 == (clamping_add<i8>(i32{100}, u8{100})));
+  EXPECT(0 == (clamping_add<u8>(i32{-5}, u32{3})));
+  EXPECT(255 == (clamping_add<u8>(i32{-5}, u64{1000})));
+  EXPECT(-128 == (clamping_add<i8>(numeric_limits<i64>::min(), u64{1})));
+  EXPECT(0 == (clamping_sub<u32>(u8{3}, i64{4})));
+  EXPECT(numeric_limits<i64>::min() ==
+         (clamping_sub<i64>(numeric_limits<i64>::min(), u64{1})));
+  EXPECT(numeric_limits<u64>::max() ==
+         (clamping_sub<u64>(numeric_limits<u64>::max(), i8{-1})));
+  EXPECT(numeric_limits<i32>::min() == (clamping_mul<i32>(i32{-70000}, 70000)));
+  EXPECT(0 == (clamping_mul<u16>(i8{-3}, u8{4})));
+  EXPECT(65535 == (clamping_mul<u16>(i8{-3}, i32{-100000})));
+
+  EXPECT(0 == (clamping_div<u8>(i32{-1000}, u8{2})));
+  EXPECT(255 == (clamping_div<u8>(i32{-1000}, i8{-2})));
+  EXPECT(-128 == (clamping_div<i8>(i32{1000}, i32{-2})));
+  EXPECT(-3 == (clamping_mod<i8>(i32{-1003}, i64{10})));
+  EXPECT(127 == (clamping_mod<i8>(u32{1000}, u32{600})));
+  EXPECT(0 == (clamping_mod<u8>(numeric_limits<i64>::min(), i8{-1})));
+  EXPECT_DEATH(clamping_div<i32>(i32{1}, u8{0}));
+  EXPECT_DEATH(clamping_mod<i32>(i32{1}, u8{0}));
+}
+
+void TestViews() {
+  vector<i16> samples{100, -30000, 30000};
+  for (clamping<i16>& x : as_clamping<i16>(samples)) {
+    x *= clamping<i16>{i16{2}};
+  }
+  EXPECT(200 == samples[0]);
+  EXPECT(numeric_limits<i16>::min() == samples[1]);
+  EXPECT(numeric_limits<i16>::max() == samples[2]);
+
+  const span<const clamping<i16>> view = as_clamping<const i16>(samples);
+  EXPECT(static_cast<const void*>(samples.data()) == view.data());
+  EXPECT(samples.data() == as_underlying(view).data());
+  EXPECT(samples.data() == as_underlying(as_clamping<i16>(samples)).data());
+}
+
+}  // namespace
+
+int main() {
+  TestClampingCast();
+  TestClampingCastAllTypes();
+  TestConstructorT();
+  TestClampingArithmetic();
+  TestClampingMixedTypes();
+  TestViews();
+}
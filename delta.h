@@ -0,0 +1,307 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DELTA_H_
+#define DELTA_H_
+
+#include <stddef.h>
+#include <string.h>
+
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "is_integral.h"
+#include "span.h"
+#include "trap.h"
+#include "wrapping.h"
+
+#if !__has_builtin(__builtin_shufflevector)
+#error delta.h needs the vector extensions of GCC or Clang.
+#endif
+
+namespace internal {
+
+// The delta kernels work on 16-byte vectors of unsigned lanes, whose
+// additions and subtractions wrap like those of `wrapping<T>`. Wider vectors
+// are no faster, because the prefix sums are a chain of dependent
+// vector operations, and 16 bytes are native to every 64-bit target.
+template <typename T>
+struct delta_types {
+  static constexpr size_t kLanes = 16 / sizeof(T);
+  typedef std::make_unsigned_t<T> vector __attribute__((vector_size(16)));
+  using indices = std::make_index_sequence<kLanes>;
+};
+
+template <typename T>
+typename delta_types<T>::vector delta_load(const T* p) {
+  typename delta_types<T>::vector v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+template <typename T>
+void delta_store(T* p, typename delta_types<T>::vector v) {
+  memcpy(p, &v, sizeof(v));
+}
+
+// Returns the last `K` lanes of `previous` followed by the first `N - K` lanes
+// of `x`.
+template <size_t K, typename Vector, size_t... I>
+Vector delta_shift_in(Vector previous, Vector x, std::index_sequence<I...>) {
+  constexpr size_t N = sizeof...(I);
+  return __builtin_shufflevector(previous, x,
+                                 (I < K ? N - K + I : N + I - K)...);
+}
+
+// Returns the last lane of `x` in every lane.
+template <typename Vector, size_t... I>
+Vector delta_broadcast_last(Vector x, std::index_sequence<I...>) {
+  return __builtin_shufflevector(x, x, ((void)I, sizeof...(I) - 1)...);
+}
+
+// Returns the inclusive prefix sums of the lanes of `x`, in log2(lanes)
+// shift-and-add steps.
+template <size_t K, typename Vector, typename Indices>
+Vector delta_prefix_sum(Vector x, Indices indices) {
+  if constexpr (K < Indices::size()) {
+    return delta_prefix_sum<2 * K>(x + delta_shift_in<K>(Vector{}, x, indices),
+                                   indices);
+  } else {
+    return x;
+  }
+}
+
+}  // namespace internal
+
+namespace integers {
+
+/// ## Delta Coding
+///
+/// Time series of timestamps and counters compress well as the differences
+/// between consecutive values (deltas), or as the differences between
+/// consecutive deltas (deltas of deltas), which are small or 0 for regular
+/// series. These functions compute the differences and their inverses in
+/// `wrapping<T>` arithmetic, so that they are well-defined for any input and
+/// decoding always restores the original values, even across overflow.
+///
+/// The input must have at least as many elements as `result`; if not, these
+/// functions `trap`. `result` may be the input, for in-place coding. You must
+/// give `T` explicitly when passing containers.
+///
+/// The functions work on vectors of 16 bytes, so that decoding, a prefix sum,
+/// is a chain of a few vector operations per vector rather than of one
+/// addition per element. Both directions run at memory bandwidth on large
+/// inputs.
+///
+/// ### `delta_encode`
+///
+/// Computes `result[i] = values[i] - values[i - 1]`, wrapping, where
+/// `values[-1]` is `base`.
+template <typename T>
+void delta_encode(span<const T> values, span<T> result, T base = 0) {
+  assert_is_integral(T);
+  if (values.size() < result.size()) {
+    trap();
+  }
+  using Types = internal::delta_types<T>;
+  constexpr size_t N = Types::kLanes;
+  typename Types::vector previous_vector = {};
+  previous_vector[N - 1] = static_cast<std::make_unsigned_t<T>>(base);
+  size_t i = 0;
+  for (; i + N <= result.size(); i += N) {
+    const auto x = internal::delta_load(&values[i]);
+    internal::delta_store(
+        &result[i],
+        x - internal::delta_shift_in<1>(previous_vector, x,
+                                        typename Types::indices{}));
+    previous_vector = x;
+  }
+  wrapping<T> previous{static_cast<T>(previous_vector[N - 1])};
+  for (; i < result.size(); i++) {
+    const wrapping<T> value{values[i]};
+    result[i] = static_cast<T>(value - previous);
+    previous = value;
+  }
+}
+
+/// ### `delta_decode`
+///
+/// The inverse of `delta_encode`: computes `result[i] = result[i - 1] +
+/// deltas[i]`, wrapping, where `result[-1]` is `base`.
+template <typename T>
+void delta_decode(span<const T> deltas, span<T> result, T base = 0) {
+  assert_is_integral(T);
+  if (deltas.size() < result.size()) {
+    trap();
+  }
+  using Types = internal::delta_types<T>;
+  constexpr size_t N = Types::kLanes;
+  constexpr typename Types::indices indices{};
+  typename Types::vector value_vector = {};
+  value_vector += static_cast<std::make_unsigned_t<T>>(base);
+  size_t i = 0;
+  for (; i + N <= result.size(); i += N) {
+    value_vector += internal::delta_prefix_sum<1>(
+        internal::delta_load(&deltas[i]), indices);
+    internal::delta_store(&result[i], value_vector);
+    value_vector = internal::delta_broadcast_last(value_vector, indices);
+  }
+  wrapping<T> value{static_cast<T>(value_vector[N - 1])};
+  for (; i < result.size(); i++) {
+    value += wrapping<T>{deltas[i]};
+    result[i] = static_cast<T>(value);
+  }
+}
+
+/// ### `delta_of_delta_encode`
+///
+/// Computes the deltas of the deltas of `values`: `result[i] = delta[i] -
+/// delta[i - 1]`, wrapping, where `delta` is as computed by `delta_encode`
+/// from `base` and `delta[-1]` is 0.
+template <typename T>
+void delta_of_delta_encode(span<const T> values, span<T> result, T base = 0) {
+  assert_is_integral(T);
+  if (values.size() < result.size()) {
+    trap();
+  }
+  using Types = internal::delta_types<T>;
+  constexpr size_t N = Types::kLanes;
+  constexpr typename Types::indices indices{};
+  typename Types::vector previous_vector = {};
+  previous_vector[N - 1] = static_cast<std::make_unsigned_t<T>>(base);
+  typename Types::vector previous_delta_vector = {};
+  size_t i = 0;
+  for (; i + N <= result.size(); i += N) {
+    const auto x = internal::delta_load(&values[i]);
+    const auto delta =
+        x - internal::delta_shift_in<1>(previous_vector, x, indices);
+    internal::delta_store(
+        &result[i],
+        delta - internal::delta_shift_in<1>(previous_delta_vector, delta,
+                                            indices));
+    previous_vector = x;
+    previous_delta_vector = delta;
+  }
+  wrapping<T> previous{static_cast<T>(previous_vector[N - 1])};
+  wrapping<T> previous_delta{static_cast<T>(previous_delta_vector[N - 1])};
+  for (; i < result.size(); i++) {
+    const wrapping<T> value{values[i]};
+    const wrapping<T> delta = value - previous;
+    result[i] = static_cast<T>(delta - previous_delta);
+    previous = value;
+    previous_delta = delta;
+  }
+}
+
+/// ### `delta_of_delta_decode`
+///
+/// The inverse of `delta_of_delta_encode`.
+template <typename T>
+void delta_of_delta_decode(span<const T> deltas_of_deltas,
+                           span<T> result,
+                           T base = 0) {
+  assert_is_integral(T);
+  if (deltas_of_deltas.size() < result.size()) {
+    trap();
+  }
+  using Types = internal::delta_types<T>;
+  constexpr size_t N = Types::kLanes;
+  constexpr typename Types::indices indices{};
+  typename Types::vector value_vector = {};
+  value_vector += static_cast<std::make_unsigned_t<T>>(base);
+  typename Types::vector delta_vector = {};
+  size_t i = 0;
+  for (; i + N <= result.size(); i += N) {
+    delta_vector += internal::delta_prefix_sum<1>(
+        internal::delta_load(&deltas_of_deltas[i]), indices);
+    value_vector += internal::delta_prefix_sum<1>(delta_vector, indices);
+    internal::delta_store(&result[i], value_vector);
+    delta_vector = internal::delta_broadcast_last(delta_vector, indices);
+    value_vector = internal::delta_broadcast_last(value_vector, indices);
+  }
+  wrapping<T> value{static_cast<T>(value_vector[N - 1])};
+  wrapping<T> delta{static_cast<T>(delta_vector[N - 1])};
+  for (; i < result.size(); i++) {
+    delta += wrapping<T>{deltas_of_deltas[i]};
+    value += delta;
+    result[i] = static_cast<T>(value);
+  }
+}
+
+/// ## Zigzag Coding
+///
+/// Deltas of a signed series are small in magnitude, but the negative ones
+/// have all their high bits set, which variable-length encodings (e.g.
+/// LEB128) handle poorly. Zigzag coding interleaves them instead: 0, -1, 1,
+/// -2, 2, ... become 0, 1, 2, 3, 4, ....
+///
+/// ### `zigzag_encode`
+///
+/// Returns the zigzag encoding of `value`.
+template <typename T>
+constexpr std::make_unsigned_t<T> zigzag_encode(T value) {
+  assert_is_integral(T);
+  static_assert(std::is_signed_v<T>, "Zigzag encodes signed values.");
+  using U = std::make_unsigned_t<T>;
+  // `value >> (bits - 1)` is all 1s for negative values and 0 otherwise.
+  constexpr int kSignBit = std::numeric_limits<U>::digits - 1;
+  return static_cast<U>(static_cast<U>(static_cast<U>(value) << 1) ^
+                        static_cast<U>(value >> kSignBit));
+}
+
+/// ### `zigzag_decode`
+///
+/// Returns the value whose zigzag encoding is `value`. The inverse of
+/// `zigzag_encode`.
+template <typename U>
+constexpr std::make_signed_t<U> zigzag_decode(U value) {
+  assert_is_integral(U);
+  static_assert(std::is_unsigned_v<U>, "Zigzag decodes unsigned values.");
+  return static_cast<std::make_signed_t<U>>(
+      static_cast<U>((value >> 1) ^ static_cast<U>(U{0} - (value & 1u))));
+}
+
+/// ### `zigzag_encode`
+///
+/// Computes `result[i] = zigzag_encode(values[i])`. `values` must have at
+/// least as many elements as `result`; if not, this function `trap`s.
+template <typename T>
+void zigzag_encode(span<const T> values,
+                   span<std::make_unsigned_t<T>> result) {
+  if (values.size() < result.size()) {
+    trap();
+  }
+  for (size_t i = 0; i < result.size(); i++) {
+    result[i] = zigzag_encode(values[i]);
+  }
+}
+
+/// ### `zigzag_decode`
+///
+/// Computes `result[i] = zigzag_decode(values[i])`. `values` must have at
+/// least as many elements as `result`; if not, this function `trap`s.
+template <typename U>
+void zigzag_decode(span<const U> values, span<std::make_signed_t<U>> result) {
+  if (values.size() < result.size()) {
+    trap();
+  }
+  for (size_t i = 0; i < result.size(); i++) {
+    result[i] = zigzag_decode(values[i]);
+  }
+}
+
+}  // namespace integers
+
+#endif  // DELTA_H_
@@ -0,0 +1,157 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "delta.h"
+#include "test_support.h"
+
+using namespace integers;
+using namespace std;
+
+namespace {
+
+using i8 = int8_t;
+using u8 = uint8_t;
+using i16 = int16_t;
+using u16 = uint16_t;
+using i32 = int32_t;
+using u32 = uint32_t;
+using i64 = int64_t;
+using u64 = uint64_t;
+
+void TestDelta() {
+  // Timestamps at a regular interval, with jitter.
+  const vector<u32> times{1000, 1010, 1020, 1031, 1040};
+  vector<u32> deltas(times.size());
+  delta_encode<u32>(times, deltas, 990);
+  EXPECT((deltas == vector<u32>{10, 10, 10, 11, 9}));
+  vector<u32> decoded(times.size());
+  delta_decode<u32>(deltas, decoded, 990);
+  EXPECT(times == decoded);
+
+  delta_of_delta_encode<u32>(times, deltas, 990);
+  EXPECT((deltas == vector<u32>{10, 0, 0, 1, static_cast<u32>(-2)}));
+  delta_of_delta_decode<u32>(deltas, decoded, 990);
+  EXPECT(times == decoded);
+
+  // A shorter `result` codes a prefix; a longer one `trap`s.
+  vector<u32> prefix(2);
+  delta_encode<u32>(times, prefix);
+  EXPECT((prefix == vector<u32>{1000, 10}));
+  vector<u32> longer(times.size() + 1);
+  EXPECT_DEATH(delta_encode<u32>(times, longer));
+  EXPECT_DEATH(delta_decode<u32>(times, longer));
+  EXPECT_DEATH(delta_of_delta_encode<u32>(times, longer));
+  EXPECT_DEATH(delta_of_delta_decode<u32>(times, longer));
+}
+
+// Any sequence, including ones whose differences overflow, round-trips, in
+// place as well.
+template <typename T>
+void GenericTestRoundTrip() {
+  constexpr T max = numeric_limits<T>::max();
+  constexpr T min = numeric_limits<T>::min();
+  vector<T> values{0, max, min, 1, max, max, min, 0, static_cast<T>(max / 3)};
+  u64 state = 7;
+  for (int i = 0; i < 1000; i++) {
+    state = state * 6364136223846793005u + 1442695040888963407u;
+    values.push_back(static_cast<T>(state >> 17));
+  }
+
+  vector<T> coded(values.size());
+  vector<T> decoded(values.size());
+  delta_encode<T>(values, coded, max);
+  for (size_t i = 1; i < values.size(); i++) {
+    EXPECT(static_cast<T>(u64(values[i]) - u64(values[i - 1])) == coded[i]);
+  }
+  delta_decode<T>(coded, decoded, max);
+  EXPECT(values == decoded);
+
+  delta_of_delta_encode<T>(values, coded, min);
+  delta_of_delta_decode<T>(coded, decoded, min);
+  EXPECT(values == decoded);
+
+  vector<T> in_place = values;
+  delta_encode<T>(in_place, in_place);
+  delta_decode<T>(in_place, in_place);
+  EXPECT(values == in_place);
+  delta_of_delta_encode<T>(in_place, in_place);
+  delta_of_delta_decode<T>(in_place, in_place);
+  EXPECT(values == in_place);
+}
+
+template <class... T>
+void CallGenericTestRoundTrip() {
+  (GenericTestRoundTrip<T>(), ...);
+}
+
+void TestRoundTrip() {
+  CallGenericTestRoundTrip<i8, u8, i16, u16, i32, u32, i64, u64>();
+}
+
+template <typename T>
+void GenericTestZigzag() {
+  using U = make_unsigned_t<T>;
+  constexpr T max = numeric_limits<T>::max();
+  constexpr T min = numeric_limits<T>::min();
+  EXPECT(0 == zigzag_encode(T{0}));
+  EXPECT(1 == zigzag_encode(T{-1}));
+  EXPECT(2 == zigzag_encode(T{1}));
+  EXPECT(3 == zigzag_encode(T{-2}));
+  EXPECT(numeric_limits<U>::max() - 1 == zigzag_encode(max));
+  EXPECT(numeric_limits<U>::max() == zigzag_encode(min));
+
+  const vector<T> values{0, -1, 1, max, min, -100, 100};
+  vector<U> encoded(values.size());
+  zigzag_encode<T>(values, encoded);
+  vector<T> decoded(values.size());
+  zigzag_decode<U>(encoded, decoded);
+  EXPECT(values == decoded);
+  for (size_t i = 0; i < values.size(); i++) {
+    EXPECT(zigzag_encode(values[i]) == encoded[i]);
+    EXPECT(values[i] == zigzag_decode(encoded[i]));
+  }
+
+  vector<U> longer(values.size() + 1);
+  EXPECT_DEATH(zigzag_encode<T>(values, longer));
+}
+
+template <class... T>
+void CallGenericTestZigzag() {
+  (GenericTestZigzag<T>(), ...);
+}
+
+void TestZigzag() {
+  CallGenericTestZigzag<i8, i16, i32, i64>();
+
+  // Delta, then zigzag, makes a decreasing series small, too.
+  const vector<i64> counters{100, 98, 97, 97, 99};
+  vector<i64> deltas(counters.size());
+  delta_encode<i64>(counters, deltas, 100);
+  vector<u64> encoded(counters.size());
+  zigzag_encode<i64>(deltas, encoded);
+  EXPECT((encoded == vector<u64>{0, 3, 1, 0, 4}));
+}
+
+}  // namespace
+
+int main() {
+  TestDelta();
+  TestRoundTrip();
+  TestZigzag();
+}
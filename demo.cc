@@ -1,8 +1,10 @@
 #include <stdlib.h>
+#include <string.h>
 
 #include <iostream>
 #include <limits>
 
+#include "charconv.h"
 #include "trapping.h"
 
 using TrappingSizeT = integers::trapping<size_t>;
@@ -132,11 +134,25 @@ int main(int count, char* arguments[]) {
 
   int checked_version = atoi(arguments[1]);
 
-  // `strtoll` returns `long long`, but for `malloc` we need `size_t`. Use the
-  // helper function to make sure the cast is safe. Don't just use
-  // `static_cast`!
-  size_t friend_count =
-      integers::trapping_cast<size_t>(strtoll(arguments[2], NULL, 0));
+  // `strtoll` returns `long long`, and silently saturates numbers too big for
+  // it; for `malloc` we need `size_t`. Parse straight into a trapping
+  // `size_t` instead, which traps if the number does not fit. Don't just use
+  // `static_cast`! (`from_chars` takes no sign, so negative counts get the
+  // help, and no `0x` prefix, so skip it and parse hexadecimal.)
+  const char* text = arguments[2];
+  const char* const last = text + strlen(text);
+  int base = 10;
+  if (last - text > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+    text += 2;
+    base = 16;
+  }
+  TrappingSizeT parsed_count{0};
+  const std::from_chars_result parsed =
+      integers::from_chars(text, last, parsed_count, base);
+  if (parsed.ec == std::errc::invalid_argument || parsed.ptr != last) {
+    help();
+  }
+  size_t friend_count = parsed_count;
 
   {
     Friend* friends = Vulnerable(friend_count);
@@ -0,0 +1,434 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXPRESSION_H_
+#define EXPRESSION_H_
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+#include "clamping.h"
+#include "is_integral.h"
+#include "trap.h"
+#include "trapping.h"
+#include "wide.h"
+
+namespace internal {
+
+#if defined(INTEGERS_HAVE_INT128)
+using bound_magnitude = uint128_t;
+#else
+using bound_magnitude = uint64_t;
+#endif
+
+/// A compile-time integer in sign-magnitude form, wide enough to hold the
+/// bounds of any expression that we can evaluate. `too_wide` is set if the
+/// value could not be represented.
+struct bound {
+  bool negative;
+  bool too_wide;
+  bound_magnitude magnitude;
+};
+
+template <typename T>
+constexpr bound make_bound(T value) {
+  if constexpr (std::is_signed_v<T>) {
+    if (value < 0) {
+      // Written this way so that `-value` cannot overflow.
+      return {true, false, static_cast<bound_magnitude>(-(value + 1)) + 1};
+    }
+  }
+  return {false, false, static_cast<bound_magnitude>(value)};
+}
+
+constexpr bool operator<(bound x, bound y) {
+  if (x.negative != y.negative) {
+    return x.negative;
+  }
+  return x.negative ? y.magnitude < x.magnitude : x.magnitude < y.magnitude;
+}
+
+constexpr bound operator-(bound x) {
+  return {!x.negative && x.magnitude != 0, x.too_wide, x.magnitude};
+}
+
+constexpr bound operator+(bound x, bound y) {
+  const bool too_wide = x.too_wide || y.too_wide;
+  if (x.negative == y.negative) {
+    const bound_magnitude sum = x.magnitude + y.magnitude;
+    return {x.negative, too_wide || sum < x.magnitude, sum};
+  }
+  if (y.magnitude < x.magnitude) {
+    return {x.negative, too_wide, x.magnitude - y.magnitude};
+  }
+  return {y.negative && x.magnitude != y.magnitude, too_wide,
+          y.magnitude - x.magnitude};
+}
+
+constexpr bound operator*(bound x, bound y) {
+  const bound_magnitude product = x.magnitude * y.magnitude;
+  const bool overflow =
+      x.magnitude != 0 && product / x.magnitude != y.magnitude;
+  return {product != 0 && x.negative != y.negative,
+          x.too_wide || y.too_wide || overflow, product};
+}
+
+/// The (inclusive) range of values that an expression can take.
+struct interval {
+  bound lowest;
+  bound highest;
+};
+
+constexpr interval hull(interval x, interval y) {
+  return {std::min(x.lowest, y.lowest), std::max(x.highest, y.highest)};
+}
+
+template <typename T>
+constexpr interval type_interval() {
+  return {make_bound(std::numeric_limits<T>::min()),
+          make_bound(std::numeric_limits<T>::max())};
+}
+
+// Returns the bit length of `x`.
+constexpr int bit_length(bound_magnitude x) {
+  int n = 0;
+  for (; x != 0; x >>= 1) {
+    n++;
+  }
+  return n;
+}
+
+/// Returns the width of the narrowest integer type that can represent every
+/// value in `range`. The type is signed if `range` includes negative values.
+/// Returns a width wider than any type if `range` could not be computed.
+constexpr int interval_bits(interval range) {
+  if (range.lowest.too_wide || range.highest.too_wide) {
+    return std::numeric_limits<int>::max();
+  }
+  if (!range.lowest.negative) {
+    return bit_length(range.highest.magnitude);
+  }
+  // An N-bit signed type holds [-2^(N-1), 2^(N-1) - 1].
+  return 1 + std::max(bit_length(range.highest.magnitude),
+                      bit_length(range.lowest.magnitude - 1));
+}
+
+struct add_operation {
+  static constexpr interval range(interval x, interval y) {
+    return {x.lowest + y.lowest, x.highest + y.highest};
+  }
+
+  template <typename W>
+  static constexpr W apply(W x, W y) {
+    return static_cast<W>(x + y);
+  }
+};
+
+struct sub_operation {
+  static constexpr interval range(interval x, interval y) {
+    return {x.lowest + -y.highest, x.highest + -y.lowest};
+  }
+
+  template <typename W>
+  static constexpr W apply(W x, W y) {
+    return static_cast<W>(x - y);
+  }
+};
+
+struct mul_operation {
+  static constexpr interval range(interval x, interval y) {
+    const bound a = x.lowest * y.lowest;
+    const bound b = x.lowest * y.highest;
+    const bound c = x.highest * y.lowest;
+    const bound d = x.highest * y.highest;
+    return {std::min(std::min(a, b), std::min(c, d)),
+            std::max(std::max(a, b), std::max(c, d))};
+  }
+
+  template <typename W>
+  static constexpr W apply(W x, W y) {
+    return static_cast<W>(x * y);
+  }
+};
+
+}  // namespace internal
+
+namespace integers {
+
+/// ## Checked Expressions
+///
+/// With `trapping<T>`, an expression like `a * b + c * d - e` is checked
+/// after every operator, and an intermediate result can overflow `T` even
+/// when the final result would not have.
+///
+/// Wrapping each operand in `expression(x)` instead builds the expression as
+/// a tree of types. From the widths of the operands, the tree computes (at
+/// compile time) an intermediate type that provably cannot overflow —
+/// `int64_t` for a product of two `int32_t`s, `__int128` for a product of two
+/// `int64_t`s, and so on. The whole expression is evaluated in that type with
+/// no checks, and the result is checked once, when it is converted to its
+/// final type:
+///
+///   trapping<int32_t> r = expression(a) * expression(b) + expression(c) * 3;
+///   clamping<uint8_t> s = expression(a) * expression(b);
+///   int16_t t = (expression(a) - expression(b)).evaluate_as<int16_t>();
+///
+/// Plain integers can be used directly as operands, but `trapping<T>` and
+/// `clamping<T>` operands must each be wrapped in `expression`; otherwise,
+/// their own operators apply. Only `+`, `-` (binary and unary), and `*` are
+/// supported: the other operators can fail regardless of width, so they still
+/// need their own checks. If an expression is too wide for any available type,
+/// it does not compile; split it into smaller expressions.
+///
+/// Each node tracks the exact range of values it can take (`kRange`), computed
+/// by interval arithmetic from the ranges of the operand types. The
+/// intermediate type (`type`) is the narrowest 32-, 64-, or 128-bit type that
+/// can hold the ranges of every node in the expression.
+
+/// ### `expression_base`
+///
+/// The common base of all expression nodes, which provides the checked
+/// conversions to the final result type. `E` is the derived node type.
+template <typename E>
+class expression_base {
+ public:
+  /// ### `operator trapping<R>`
+  ///
+  /// Evaluates the expression and returns the result as a `trapping<R>`.
+  /// `trap`s if `R` cannot represent the result.
+  template <typename R>
+  operator trapping<R>() const {
+    return trapping<R>(evaluate_as<R>());
+  }
+
+  /// ### `operator clamping<R>`
+  ///
+  /// Evaluates the expression and returns the result as a `clamping<R>`,
+  /// clamped to `R`’s range.
+  template <typename R>
+  operator clamping<R>() const {
+    return clamping<R>(evaluate_clamped_as<R>());
+  }
+
+  /// ### `evaluate_as`
+  ///
+  /// Evaluates the expression and returns the result as an `R`. `trap`s if
+  /// `R` cannot represent the result.
+  template <typename R>
+  R evaluate_as() const {
+    assert_is_integral(R);
+    const auto value = self().evaluate();
+    if (!internal::wide_in_range<R>(value)) {
+      trap();
+    }
+    return static_cast<R>(value);
+  }
+
+  /// ### `evaluate_clamped_as`
+  ///
+  /// Evaluates the expression and returns the result as an `R`, clamped to
+  /// `R`’s range.
+  template <typename R>
+  constexpr R evaluate_clamped_as() const {
+    assert_is_integral(R);
+    return internal::wide_clamp<R>(self().evaluate());
+  }
+
+ private:
+  const E& self() const { return static_cast<const E&>(*this); }
+};
+
+/// ### `expression_leaf<T>`
+///
+/// An operand of an expression: a plain `T`.
+template <typename T>
+class expression_leaf : public expression_base<expression_leaf<T>> {
+  assert_is_integral(T);
+
+ public:
+  static constexpr internal::interval kRange = internal::type_interval<T>();
+  static constexpr internal::interval kSubtreeRange = kRange;
+  using type = internal::wide_integer_t<internal::interval_bits(kSubtreeRange),
+                                        kSubtreeRange.lowest.negative>;
+
+  constexpr explicit expression_leaf(T value) : value_(value) {}
+
+  template <typename W>
+  constexpr W evaluate_in() const {
+    return static_cast<W>(value_);
+  }
+
+  constexpr type evaluate() const { return evaluate_in<type>(); }
+
+ private:
+  T value_;
+};
+
+/// ### `expression_binary<Operation, L, R>`
+///
+/// The result of applying `Operation` to the expressions `L` and `R`.
+template <typename Operation, typename L, typename R>
+class expression_binary
+    : public expression_base<expression_binary<Operation, L, R>> {
+ public:
+  static constexpr internal::interval kRange =
+      Operation::range(L::kRange, R::kRange);
+  static constexpr internal::interval kSubtreeRange =
+      hull(kRange, hull(L::kSubtreeRange, R::kSubtreeRange));
+  using type = internal::wide_integer_t<internal::interval_bits(kSubtreeRange),
+                                        kSubtreeRange.lowest.negative>;
+
+  constexpr expression_binary(L lhs, R rhs) : lhs_(lhs), rhs_(rhs) {}
+
+  // `type` can represent the values of every sub-expression, so evaluating
+  // them all in `type` cannot overflow.
+  template <typename W>
+  constexpr W evaluate_in() const {
+    return Operation::template apply<W>(lhs_.template evaluate_in<W>(),
+                                        rhs_.template evaluate_in<W>());
+  }
+
+  constexpr type evaluate() const { return evaluate_in<type>(); }
+
+ private:
+  L lhs_;
+  R rhs_;
+};
+
+/// ### `expression_negate<E>`
+///
+/// The negation of the expression `E`.
+template <typename E>
+class expression_negate : public expression_base<expression_negate<E>> {
+ public:
+  static constexpr internal::interval kRange = {-E::kRange.highest,
+                                                -E::kRange.lowest};
+  static constexpr internal::interval kSubtreeRange =
+      hull(kRange, E::kSubtreeRange);
+  using type = internal::wide_integer_t<internal::interval_bits(kSubtreeRange),
+                                        kSubtreeRange.lowest.negative>;
+
+  constexpr explicit expression_negate(E operand) : operand_(operand) {}
+
+  template <typename W>
+  constexpr W evaluate_in() const {
+    return static_cast<W>(-operand_.template evaluate_in<W>());
+  }
+
+  constexpr type evaluate() const { return evaluate_in<type>(); }
+
+ private:
+  E operand_;
+};
+
+/// ### `is_expression_v<T>`
+///
+/// True if `T` is an expression node type.
+template <typename T>
+constexpr bool is_expression_v = std::is_base_of_v<expression_base<T>, T>;
+
+/// ### `expression`
+///
+/// Starts an expression with the operand `x`, which may be a `trapping<T>`, a
+/// `clamping<T>`, or a plain integer. If `x` is already an expression, returns
+/// it unchanged.
+template <typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+constexpr expression_leaf<T> expression(T x) {
+  return expression_leaf<T>(x);
+}
+
+template <typename T>
+expression_leaf<T> expression(trapping<T> x) {
+  return expression_leaf<T>(static_cast<T>(x));
+}
+
+template <typename T>
+expression_leaf<T> expression(clamping<T> x) {
+  return expression_leaf<T>(static_cast<T>(x));
+}
+
+template <typename E, std::enable_if_t<is_expression_v<E>, int> = 0>
+constexpr E expression(const E& e) {
+  return e;
+}
+
+}  // namespace integers
+
+namespace internal {
+
+// True if `L op R` should build an expression node: one side must already be
+// an expression, and the other must be an expression or a plain integer.
+template <typename L, typename R>
+constexpr bool is_expression_operands_v =
+    (integers::is_expression_v<L> || integers::is_expression_v<R>) &&
+    (integers::is_expression_v<L> || std::is_integral_v<L>) &&
+    (integers::is_expression_v<R> || std::is_integral_v<R>);
+
+template <typename Operation, typename L, typename R>
+using expression_binary_t = integers::expression_binary<
+    Operation,
+    decltype(integers::expression(std::declval<L>())),
+    decltype(integers::expression(std::declval<R>()))>;
+
+}  // namespace internal
+
+namespace integers {
+
+/// ### `operator+`
+///
+/// Returns the (unevaluated) sum of `lhs` and `rhs`.
+template <typename L,
+          typename R,
+          std::enable_if_t<internal::is_expression_operands_v<L, R>, int> = 0>
+constexpr auto operator+(const L& lhs, const R& rhs) {
+  return internal::expression_binary_t<internal::add_operation, L, R>(
+      expression(lhs), expression(rhs));
+}
+
+/// ### `operator-`
+///
+/// Returns the (unevaluated) difference of `lhs` and `rhs`.
+template <typename L,
+          typename R,
+          std::enable_if_t<internal::is_expression_operands_v<L, R>, int> = 0>
+constexpr auto operator-(const L& lhs, const R& rhs) {
+  return internal::expression_binary_t<internal::sub_operation, L, R>(
+      expression(lhs), expression(rhs));
+}
+
+/// ### `operator*`
+///
+/// Returns the (unevaluated) product of `lhs` and `rhs`.
+template <typename L,
+          typename R,
+          std::enable_if_t<internal::is_expression_operands_v<L, R>, int> = 0>
+constexpr auto operator*(const L& lhs, const R& rhs) {
+  return internal::expression_binary_t<internal::mul_operation, L, R>(
+      expression(lhs), expression(rhs));
+}
+
+/// ### `operator-`
+///
+/// Returns the (unevaluated) negation of `e`.
+template <typename E, std::enable_if_t<is_expression_v<E>, int> = 0>
+constexpr expression_negate<E> operator-(const E& e) {
+  return expression_negate<E>(e);
+}
+
+}  // namespace integers
+
+#endif  // EXPRESSION_H_
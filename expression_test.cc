@@ -0,0 +1,163 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <limits>
+#include <type_traits>
+
+#include "expression.h"
+#include "test_support.h"
+
+using namespace integers;
+using namespace std;
+
+namespace {
+
+using i8 = int8_t;
+using u8 = uint8_t;
+using i16 = int16_t;
+using i32 = int32_t;
+using u32 = uint32_t;
+using i64 = int64_t;
+using u64 = uint64_t;
+
+constexpr i32 i32_max = numeric_limits<i32>::max();
+constexpr i32 i32_min = numeric_limits<i32>::min();
+constexpr u32 u32_max = numeric_limits<u32>::max();
+constexpr i64 i64_max = numeric_limits<i64>::max();
+constexpr i64 i64_min = numeric_limits<i64>::min();
+constexpr u64 u64_max = numeric_limits<u64>::max();
+
+// True if the expression `E` is evaluated in type `T`.
+template <typename E, typename T>
+constexpr bool evaluates_in_v = is_same_v<typename E::type, T>;
+
+void TestIntermediateType() {
+  const auto a = expression(i32{1});
+  const auto b = expression(u32{1});
+  const auto c = expression(i64{1});
+  const auto d = expression(u64{1});
+  const auto e = expression(i8{1});
+
+  static_assert(evaluates_in_v<decltype(a * a), i64>, "i32 * i32 in i64");
+  static_assert(evaluates_in_v<decltype(a + a), i64>, "i32 + i32 in i64");
+  static_assert(evaluates_in_v<decltype(e * e + e), i32>, "i8 in i32");
+  static_assert(evaluates_in_v<decltype(b * b), u64>, "u32 * u32 in u64");
+  static_assert(evaluates_in_v<decltype(b + b), u64>, "u32 + u32 in u64");
+  static_assert(evaluates_in_v<decltype(b - b), i64>, "u32 - u32 in i64");
+#if defined(INTEGERS_HAVE_INT128)
+  // The sum can be 2^63, which `i64` cannot represent.
+  static_assert(evaluates_in_v<decltype(a * a + a * a), internal::int128_t>,
+                "i32 * i32 + i32 * i32 in int128_t");
+  static_assert(evaluates_in_v<decltype(c * c - c * c), internal::int128_t>,
+                "i64 * i64 - i64 * i64 in int128_t");
+  static_assert(evaluates_in_v<decltype(d * d), internal::uint128_t>,
+                "u64 * u64 in uint128_t");
+#endif
+  (void)a;
+  (void)b;
+  (void)c;
+  (void)d;
+  (void)e;
+}
+
+void TestIntermediateOverflow() {
+  {
+    // `a * b` overflows `i32`, but the whole expression does not.
+    trapping<i32> a{i32_max};
+    trapping<i32> b{2};
+    trapping<i32> c{i32_max};
+    trapping<i32> r = expression(a) * expression(b) - expression(c) * 2 + 7;
+    EXPECT(r == 7);
+  }
+  {
+    trapping<i32> a{i32_min};
+    trapping<i32> r =
+        expression(a) * expression(a) - expression(a) * expression(a);
+    EXPECT(r == 0);
+  }
+  {
+    const i32 r = (expression(i32_max) + 1 - 2).evaluate_as<i32>();
+    EXPECT(r == i32_max - 1);
+  }
+  {
+    const u32 r = (expression(u32_max) * 3 - expression(u32_max) * 2)
+                      .evaluate_as<u32>();
+    EXPECT(r == u32_max);
+  }
+  {
+    const i64 r = (-expression(i64_min) - 1).evaluate_as<i64>();
+    EXPECT(r == i64_max);
+  }
+#if defined(INTEGERS_HAVE_INT128)
+  {
+    const i64 r =
+        (expression(i64_max) * i64_max - expression(i64_max) * (i64_max - 1))
+            .evaluate_as<i64>();
+    EXPECT(r == i64_max);
+  }
+  {
+    const u64 r = (expression(u64_max) * u64_max).evaluate_clamped_as<u64>();
+    EXPECT(r == u64_max);
+  }
+#endif
+}
+
+void TestFinalCheck() {
+  {
+    trapping<i32> a{i32_max};
+    trapping<i32> x;
+    EXPECT_DEATH((x = expression(a) + 1));
+  }
+  {
+    trapping<i32> a{i32_min};
+    trapping<i32> x;
+    EXPECT_DEATH((x = -expression(a)));
+  }
+  {
+    EXPECT_DEATH((expression(i32{0}) - 1).evaluate_as<u32>());
+  }
+  {
+    EXPECT_DEATH((expression(u8{16}) * u8{16}).evaluate_as<u8>());
+  }
+}
+
+void TestClamping() {
+  {
+    clamping<u8> a{u8{200}};
+    clamping<u8> r = expression(a) * expression(a);
+    EXPECT(static_cast<u8>(r) == 255);
+  }
+  {
+    clamping<i16> r = expression(i32_min) * 2;
+    EXPECT(static_cast<i16>(r) == numeric_limits<i16>::min());
+  }
+  {
+    const u32 r = (expression(i32{0}) - 1).evaluate_clamped_as<u32>();
+    EXPECT(r == 0);
+  }
+  {
+    const i8 r = (expression(i8{100}) * 3 - 250).evaluate_clamped_as<i8>();
+    EXPECT(r == 50);
+  }
+}
+
+}  // namespace
+
+int main() {
+  TestIntermediateType();
+  TestIntermediateOverflow();
+  TestFinalCheck();
+  TestClamping();
+}
@@ -0,0 +1,139 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OVERFLOW_STATUS_H_
+#define OVERFLOW_STATUS_H_
+
+#include <stdint.h>
+
+namespace integers {
+
+/// ## Sticky Overflow Status
+///
+/// If you define `INTEGERS_STICKY_OVERFLOW` before including trapping.h, the
+/// trapping helper functions (`trapping_cast`, `trapping_add`, `trapping_sub`,
+/// `trapping_mul`, `trapping_div`, and `trapping_mod`) do not `trap`. Instead,
+/// they return the wrapped or truncated result, and record the overflow in a
+/// thread-local, sticky status word — much like floating-point exceptions and
+/// `fetestexcept`. You check the status once per batch:
+///
+///   for (size_t i = 0; i < count; i++) {
+///     out[i] = trapping_add<int32_t>(a[i], b[i]);
+///   }
+///   if (test_and_clear_overflow() != overflow_flags::none) {
+///     // Reject the batch.
+///   }
+///
+/// Recording is branchless, so loops like this one can still be vectorized.
+/// (The status word is an `enum class`, which compilers know cannot alias the
+/// integers in your arrays, so they can keep it in a register for the
+/// duration of the loop.)
+///
+/// Only operations built on those helpers are sticky: the `trapping<T>`
+/// constructors from other types, its `+`, `-`, `*`, `/`, and `%` operators
+/// (and their assignment forms), and the batch, SIMD, reduction, varint, and
+/// parsing functions that document it. The other `trapping<T>` operations
+/// still `trap`: negation and `abs` of the minimum value, shifts by invalid
+/// counts or that overflow, and bitwise operators and comparisons with
+/// operands of other types that `T` cannot represent.
+///
+/// The macro changes the definitions of inline functions and templates, so
+/// define it (or not) consistently for every translation unit in the
+/// program, e.g. on the compiler command line. Otherwise, the program
+/// violates the one-definition rule, and the linker may silently pick
+/// either definition.
+///
+/// You can also use `record_overflow` and `test_and_clear_overflow` without
+/// defining `INTEGERS_STICKY_OVERFLOW`, e.g. to record your own checks.
+///
+/// ### `overflow_flags`
+///
+/// The bits of the status word: which kinds of operation have overflowed.
+enum class overflow_flags : uint32_t {
+  none = 0,
+  cast = 1 << 0,
+  add = 1 << 1,
+  sub = 1 << 2,
+  mul = 1 << 3,
+  div = 1 << 4,
+  mod = 1 << 5,
+  all = cast | add | sub | mul | div | mod,
+};
+
+constexpr overflow_flags operator|(overflow_flags x, overflow_flags y) {
+  return static_cast<overflow_flags>(static_cast<uint32_t>(x) |
+                                     static_cast<uint32_t>(y));
+}
+
+constexpr overflow_flags operator&(overflow_flags x, overflow_flags y) {
+  return static_cast<overflow_flags>(static_cast<uint32_t>(x) &
+                                     static_cast<uint32_t>(y));
+}
+
+constexpr overflow_flags operator~(overflow_flags x) {
+  return static_cast<overflow_flags>(~static_cast<uint32_t>(x)) &
+         overflow_flags::all;
+}
+
+}  // namespace integers
+
+namespace internal {
+
+inline thread_local integers::overflow_flags overflow_status =
+    integers::overflow_flags::none;
+
+}  // namespace internal
+
+namespace integers {
+
+/// ### `record_overflow`
+///
+/// Sets `flags` in this thread’s status word if `overflowed` is true, without
+/// branching.
+inline void record_overflow(bool overflowed, overflow_flags flags) {
+  const uint32_t mask = static_cast<uint32_t>(flags) * overflowed;
+  internal::overflow_status =
+      internal::overflow_status | static_cast<overflow_flags>(mask);
+}
+
+/// ### `test_overflow`
+///
+/// Returns which of `flags` are set in this thread’s status word. Like
+/// `fetestexcept`.
+inline overflow_flags test_overflow(
+    overflow_flags flags = overflow_flags::all) {
+  return internal::overflow_status & flags;
+}
+
+/// ### `clear_overflow`
+///
+/// Clears `flags` in this thread’s status word. Like `feclearexcept`.
+inline void clear_overflow(overflow_flags flags = overflow_flags::all) {
+  internal::overflow_status = internal::overflow_status & ~flags;
+}
+
+/// ### `test_and_clear_overflow`
+///
+/// Returns which of `flags` are set in this thread’s status word, and clears
+/// them.
+inline overflow_flags test_and_clear_overflow(
+    overflow_flags flags = overflow_flags::all) {
+  const overflow_flags result = test_overflow(flags);
+  clear_overflow(flags);
+  return result;
+}
+
+}  // namespace integers
+
+#endif  // OVERFLOW_STATUS_H_
@@ -0,0 +1,240 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#define INTEGERS_STICKY_OVERFLOW
+
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "batch.h"
+#include "charconv.h"
+#include "overflow_status.h"
+#include "parallel.h"
+#include "reduce.h"
+#include "simd.h"
+#include "summed_area.h"
+#include "test_support.h"
+#include "trapping.h"
+#include "varint.h"
+
+using namespace integers;
+using namespace std;
+
+namespace {
+
+using i8 = int8_t;
+using u8 = uint8_t;
+using i16 = int16_t;
+using u16 = uint16_t;
+using i32 = int32_t;
+using u32 = uint32_t;
+using i64 = int64_t;
+using u64 = uint64_t;
+
+void TestRecordOverflow() {
+  clear_overflow();
+  EXPECT(overflow_flags::none == test_overflow());
+  record_overflow(false, overflow_flags::add);
+  EXPECT(overflow_flags::none == test_overflow());
+  record_overflow(true, overflow_flags::add);
+  record_overflow(true, overflow_flags::mul);
+  EXPECT((overflow_flags::add | overflow_flags::mul) == test_overflow());
+  EXPECT(overflow_flags::mul == test_overflow(overflow_flags::mul));
+  EXPECT(overflow_flags::none == test_overflow(overflow_flags::sub));
+
+  // Flags are sticky until cleared.
+  record_overflow(false, overflow_flags::add);
+  EXPECT(overflow_flags::add == test_overflow(overflow_flags::add));
+
+  EXPECT(overflow_flags::add == test_and_clear_overflow(overflow_flags::add));
+  EXPECT(overflow_flags::mul == test_overflow());
+  EXPECT(overflow_flags::mul == test_and_clear_overflow());
+  EXPECT(overflow_flags::none == test_overflow());
+}
+
+template <typename T>
+void GenericTestHelpers() {
+  constexpr T max = numeric_limits<T>::max();
+  constexpr T min = numeric_limits<T>::min();
+  clear_overflow();
+
+  EXPECT(min == (trapping_add<T, T, T>(max, 1)));
+  EXPECT(overflow_flags::add == test_and_clear_overflow());
+
+  EXPECT(max == (trapping_sub<T, T, T>(min, 1)));
+  EXPECT(overflow_flags::sub == test_and_clear_overflow());
+
+  (void)trapping_mul<T, T, T>(max, 2);
+  EXPECT(overflow_flags::mul == test_and_clear_overflow());
+
+  EXPECT(0 == (trapping_div<T, T, T>(max, 0)));
+  EXPECT(overflow_flags::div == test_and_clear_overflow());
+
+  EXPECT(0 == (trapping_mod<T, T, T>(max, 0)));
+  EXPECT(overflow_flags::mod == test_and_clear_overflow());
+
+  (void)trapping_cast<T>(numeric_limits<u64>::max());
+  (void)trapping_cast<T>(numeric_limits<i64>::min());
+  EXPECT(overflow_flags::cast == test_and_clear_overflow());
+
+  // Mixed types go through the intrinsics rather than the vectorizable
+  // versions; they should agree.
+  (void)trapping_add<T, u64, u64>(u64{max}, 1);
+  (void)trapping_add<T, T, T>(max, 1);
+  EXPECT(overflow_flags::add == test_and_clear_overflow());
+
+  // In-range operations record nothing.
+  EXPECT(max == (trapping_add<T, T, T>(max - 1, 1)));
+  EXPECT(max == (trapping_sub<T, T, T>(max, 0)));
+  EXPECT(max == (trapping_mul<T, T, T>(max, 1)));
+  EXPECT(max == (trapping_div<T, T, T>(max, 1)));
+  EXPECT(max == (trapping_cast<T>(max)));
+  EXPECT(overflow_flags::none == test_overflow());
+}
+
+template <class... T>
+void CallGenericTestHelpers() {
+  (GenericTestHelpers<T>(), ...);
+}
+
+void TestHelpers() {
+  CallGenericTestHelpers<i8, u8, i16, u16, i32, u32, i64, u64>();
+}
+
+void TestTrappingOperators() {
+  clear_overflow();
+  trapping<i32> x{numeric_limits<i32>::max()};
+  x += 1;
+  EXPECT(x == numeric_limits<i32>::min());
+  x *= 2;
+  EXPECT((overflow_flags::add | overflow_flags::mul) ==
+         test_and_clear_overflow());
+}
+
+// The status is per thread, and must record an overflow anywhere in a batch,
+// regardless of the other elements.
+void TestBatch() {
+  i32 a[64];
+  i32 b[64];
+  i32 out[64];
+  for (i32 i = 0; i < 64; i++) {
+    a[i] = i;
+    b[i] = i;
+  }
+  clear_overflow();
+  for (size_t i = 0; i < 64; i++) {
+    out[i] = trapping_mul<i32>(a[i], b[i]);
+  }
+  EXPECT(overflow_flags::none == test_and_clear_overflow());
+  EXPECT(63 * 63 == out[63]);
+
+  a[37] = numeric_limits<i32>::max();
+  for (size_t i = 0; i < 64; i++) {
+    out[i] = trapping_mul<i32>(a[i], b[i]);
+  }
+  EXPECT(overflow_flags::mul == test_and_clear_overflow());
+
+  // The span functions record overflow, and write every result.
+  trapping_add<i32>(a, b, out);
+  EXPECT(overflow_flags::add == test_and_clear_overflow());
+  EXPECT(out[37] == numeric_limits<i32>::min() + 36);
+  EXPECT(out[63] == 126);
+  trapping_sub<i32>(a, i32{1}, out);
+  EXPECT(overflow_flags::none == test_and_clear_overflow());
+
+  i8 narrow[64];
+  trapping_cast<i8, i32>(b, narrow);
+  EXPECT(overflow_flags::none == test_and_clear_overflow());
+  trapping_cast<i8, i32>(a, narrow);
+  EXPECT(overflow_flags::cast == test_and_clear_overflow());
+  EXPECT(narrow[37] == -1);
+  EXPECT(narrow[63] == 63);
+
+  EXPECT(63 * 64 / 2 == (checked_sum<i32, i32>(b)));
+  EXPECT(overflow_flags::none == test_and_clear_overflow());
+  checked_sum<i32, i32>(a);
+  EXPECT(overflow_flags::add == test_and_clear_overflow());
+
+  u8 pixels[64];
+  u16 table[64];
+  for (u8& pixel : pixels) {
+    pixel = 255;
+  }
+  summed_area_table<u16, u8>(pixels, 8, 8, table);
+  EXPECT(overflow_flags::none == test_and_clear_overflow());
+  u8 narrow_table[64];
+  summed_area_table<u8, u8>(pixels, 8, 8, narrow_table);
+  EXPECT(overflow_flags::add == test_and_clear_overflow());
+
+  // Vectors record overflow in any lane, and keep the wrapped lanes.
+  const auto v = trapping_simd<i32, 4>::load(a + 34) * 2;
+  EXPECT(overflow_flags::mul == test_and_clear_overflow());
+  EXPECT(-2 == v[3]);
+  EXPECT(70 == v[1]);
+
+  // Varints that do not fit are truncated.
+  const u8 varint[] = {0xAC, 0x02};
+  u8 small = 0;
+  EXPECT(2 == trapping_varint_decode<u8>(varint, &small));
+  EXPECT(overflow_flags::cast == test_and_clear_overflow());
+  EXPECT(0x2C == small);
+
+  // Numbers that do not fit leave the value unchanged when parsed singly, and
+  // are clamped in columns.
+  const char text[] = "300,-7";
+  trapping<u8> parsed{1};
+  EXPECT(errc::result_out_of_range ==
+         integers::from_chars(text, text + 3, parsed).ec);
+  EXPECT(overflow_flags::cast == test_and_clear_overflow());
+  EXPECT(1 == parsed);
+  i8 column[2];
+  EXPECT(text + 6 ==
+         trapping_from_chars_column<i8>(text, text + 6, ',', column));
+  EXPECT(overflow_flags::cast == test_and_clear_overflow());
+  EXPECT(127 == column[0] && -7 == column[1]);
+}
+
+// Overflows on worker threads are recorded in the calling thread's status.
+void TestParallel() {
+  const size_t count = 4 * internal::kParallelMinimumSlice;
+  vector<i32> a(count, 1);
+  vector<i32> out(count);
+  clear_overflow();
+  parallel_trapping_add<i32>(a, 1, out, 4);
+  EXPECT(overflow_flags::none == test_and_clear_overflow());
+  EXPECT(2 == out[count - 1]);
+
+  a[count - 1] = numeric_limits<i32>::max();
+  parallel_trapping_add<i32>(a, 1, out, 4);
+  EXPECT(overflow_flags::add == test_and_clear_overflow());
+  EXPECT(numeric_limits<i32>::min() == out[count - 1]);
+  parallel_trapping_mul<i32>(a, 2, out, 4);
+  EXPECT(overflow_flags::mul == test_and_clear_overflow());
+  parallel_checked_sum<i32, i32>(a, 4);
+  EXPECT(overflow_flags::add == test_and_clear_overflow());
+  EXPECT(count + 1 == static_cast<size_t>(parallel_checked_sum<i64, i32>(
+                          vector<i32>(count + 1, 1), 4)));
+  EXPECT(overflow_flags::none == test_overflow());
+}
+
+}  // namespace
+
+int main() {
+  TestRecordOverflow();
+  TestHelpers();
+  TestTrappingOperators();
+  TestBatch();
+  TestParallel();
+}
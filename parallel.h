@@ -0,0 +1,499 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PARALLEL_H_
+#define PARALLEL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "batch.h"
+#include "is_integral.h"
+#include "overflow_status.h"
+#include "reduce.h"
+#include "span.h"
+#include "trap.h"
+#include "wide.h"
+
+namespace internal {
+
+// Each thread gets at least this many elements, so that starting it costs
+// much less than the work it does.
+constexpr size_t kParallelMinimumSlice = size_t{1} << 16;
+
+// Returns the number of threads to split `count` elements across: `threads`,
+// or if that is 0 the number of hardware threads, but no more than leaves each
+// at least `kParallelMinimumSlice` elements.
+inline size_t parallel_thread_count(size_t count, size_t threads) {
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  return std::max(size_t{1},
+                  std::min(threads, count / kParallelMinimumSlice));
+}
+
+// Splits `[0, count)` into `slices` contiguous slices, and calls
+// `f(slice, begin, end)` for each, each on its own thread (the first on the
+// calling thread). Returns when all calls have returned.
+//
+// The slices depend only on `count` and `slices`, never on scheduling, so
+// results combined in slice order are deterministic.
+template <typename F>
+void parallel_slices(size_t count, size_t slices, F f) {
+  const auto bounds = [count, slices](size_t slice) {
+    return count / slices * slice + std::min(slice, count % slices);
+  };
+  std::vector<std::thread> workers;
+  workers.reserve(slices - 1);
+  for (size_t slice = 1; slice < slices; slice++) {
+    workers.emplace_back(f, slice, bounds(slice), bounds(slice + 1));
+  }
+  f(size_t{0}, bounds(0), bounds(1));
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+// Returns the part `[begin, end)` of a batch operand, which is either a span
+// or a broadcast scalar.
+template <typename T>
+integers::span<const T> batch_slice(integers::span<const T> x,
+                                    size_t begin,
+                                    size_t end) {
+  return x.subspan(begin, end - begin);
+}
+
+template <typename T>
+T batch_slice(T x, size_t, size_t) {
+  return x;
+}
+
+// Like `batch_until_overflow`, but splits the work across `threads` threads.
+// Returns the index of the first element that overflows, or `result.size()`
+// if none does, no matter which thread finds it first. Elements before that
+// index are written; others may or may not be.
+template <typename T, typename X, typename Y, typename Op>
+size_t parallel_until_overflow(X x,
+                               Y y,
+                               integers::span<T> result,
+                               size_t threads,
+                               Op op) {
+  if (batch_size(x) < result.size() || batch_size(y) < result.size()) {
+    trap();
+  }
+  const size_t slices = parallel_thread_count(result.size(), threads);
+  std::vector<size_t> first(slices);
+  parallel_slices(
+      result.size(), slices, [&](size_t slice, size_t begin, size_t end) {
+        const size_t bad = batch_until_overflow(
+            batch_slice(x, begin, end), batch_slice(y, begin, end),
+            result.subspan(begin, end - begin), op);
+        first[slice] = bad == end - begin ? result.size() : begin + bad;
+      });
+  return *std::min_element(first.begin(), first.end());
+}
+
+// Like `batch_any_overflow`, but splits the work across `threads` threads.
+template <typename T, typename X, typename Y, typename Op>
+bool parallel_any_overflow(X x,
+                           Y y,
+                           integers::span<T> result,
+                           size_t threads,
+                           Op op) {
+  if (batch_size(x) < result.size() || batch_size(y) < result.size()) {
+    trap();
+  }
+  const size_t slices = parallel_thread_count(result.size(), threads);
+  // Not `std::vector<bool>`, whose elements threads cannot write
+  // independently.
+  std::vector<uint8_t> overflow(slices);
+  parallel_slices(
+      result.size(), slices, [&](size_t slice, size_t begin, size_t end) {
+        overflow[slice] = batch_any_overflow(
+            batch_slice(x, begin, end), batch_slice(y, begin, end),
+            result.subspan(begin, end - begin), op);
+      });
+  return std::find(overflow.begin(), overflow.end(), 1) != overflow.end();
+}
+
+// Like `batch_trapping`, but splits the work across `threads` threads. The
+// overflow status is thread-local, so in sticky mode, the calling thread
+// records the workers’ overflows.
+template <typename T, typename X, typename Y, typename Op>
+void parallel_trapping(X x,
+                       Y y,
+                       integers::span<T> result,
+                       size_t threads,
+                       integers::overflow_flags flag,
+                       Op op) {
+#if defined(INTEGERS_STICKY_OVERFLOW)
+  integers::record_overflow(parallel_any_overflow(x, y, result, threads, op),
+                            flag);
+#else
+  static_cast<void>(flag);
+  if (parallel_until_overflow(x, y, result, threads, op) != result.size()) {
+    trap();
+  }
+#endif
+}
+
+// Like `checked_accumulate`, but splits the work across `threads` threads, and
+// merges their totals in order.
+template <typename Term, typename F>
+bool parallel_checked_accumulate(
+    size_t count,
+    size_t threads,
+    F term,
+    widest_integer_t<is_signed_wide_v<Term>>* total) {
+  using Total = widest_integer_t<is_signed_wide_v<Term>>;
+  const size_t slices = parallel_thread_count(count, threads);
+  std::vector<Total> totals(slices);
+  std::vector<uint8_t> overflow(slices);
+  parallel_slices(count, slices, [&](size_t slice, size_t begin, size_t end) {
+    overflow[slice] = checked_accumulate<Term>(
+        end - begin, [&term, begin](size_t i) { return term(begin + i); },
+        &totals[slice]);
+  });
+  *total = 0;
+  bool any = false;
+  for (size_t slice = 0; slice < slices; slice++) {
+    any |= overflow[slice] != 0;
+    any |= wide_add_overflow(*total, totals[slice], total);
+  }
+  return any;
+}
+
+// Like `checked_scan` (starting from 0), but splits the work across `threads`
+// threads, in two passes: the first sums each slice but the last, and the
+// second scans each slice starting from the sum of the slices before it.
+template <typename R, typename T>
+size_t parallel_checked_scan(integers::span<const T> values,
+                             integers::span<R> result,
+                             size_t threads) {
+  using Total = widest_integer_t<std::is_signed_v<T>>;
+  const size_t slices = parallel_thread_count(values.size(), threads);
+  if (slices == 1) {
+    return checked_scan(values, result, R{0});
+  }
+
+  std::vector<Total> starts(slices);
+  std::vector<uint8_t> overflow(slices);
+  parallel_slices(
+      values.size(), slices, [&](size_t slice, size_t begin, size_t end) {
+        if (slice + 1 < slices) {
+          overflow[slice] = checked_accumulate<T>(
+              end - begin,
+              [values, begin](size_t i) { return values[begin + i]; },
+              &starts[slice]);
+        }
+      });
+  Total total = 0;
+  for (size_t slice = 0; slice < slices; slice++) {
+    const Total sum = starts[slice];
+    starts[slice] = total;
+    if (overflow[slice] || wide_add_overflow(total, sum, &total)) {
+      // Only for inputs summing to about 2**64 (or 2**128); not worth
+      // splitting.
+      return checked_scan(values, result, R{0});
+    }
+  }
+
+  std::vector<size_t> first(slices);
+  parallel_slices(
+      values.size(), slices, [&](size_t slice, size_t begin, size_t end) {
+        first[slice] = result.size();
+        // If `R` cannot represent the start, it could not represent the last
+        // total of the slice before, which reports it.
+        if (wide_in_range<R>(starts[slice])) {
+          const size_t bad =
+              checked_scan(values.subspan(begin, end - begin),
+                           result.subspan(begin, end - begin),
+                           static_cast<R>(starts[slice]));
+          if (bad != end - begin) {
+            first[slice] = begin + bad;
+          }
+        }
+      });
+  return *std::min_element(first.begin(), first.end());
+}
+
+}  // namespace internal
+
+namespace integers {
+
+/// ## Parallel Operations
+///
+/// These functions are like the checked reductions in reduce.h and the batch
+/// operations in batch.h, but split large spans across threads. They divide
+/// the span into one contiguous slice per thread (each processed in
+/// cache-sized chunks, as the single-threaded versions do), and combine the
+/// threads’ results in order. So their results, including which overflow they
+/// report, are deterministic: they do not depend on how the threads are
+/// scheduled.
+///
+/// `threads` is the most threads to use, including the calling thread; 0
+/// means one per hardware thread. Each thread gets at least 65,536 elements,
+/// so small spans use fewer threads (or just the calling thread).
+///
+/// The functions start their threads afresh on each call. That costs tens of
+/// microseconds, which is small next to the work on spans big enough to
+/// split.
+///
+/// The overflow status is thread-local, so if `INTEGERS_STICKY_OVERFLOW` is
+/// defined, these functions record the overflows that their threads find in
+/// the calling thread’s status.
+///
+/// ### `parallel_checked_sum`
+///
+/// Like `checked_sum`.
+template <typename R, typename T>
+R parallel_checked_sum(span<const T> values, size_t threads = 0) {
+  assert_is_integral(R);
+  assert_is_integral(T);
+
+  internal::widest_integer_t<std::is_signed_v<T>> total;
+  const bool overflow = internal::parallel_checked_accumulate<T>(
+      values.size(), threads, [values](size_t i) { return values[i]; },
+      &total);
+  return internal::checked_reduction_result<R>(overflow, total,
+                                               overflow_flags::add);
+}
+
+/// ### `parallel_checked_dot`
+///
+/// Like `checked_dot`.
+template <typename R, typename T>
+R parallel_checked_dot(span<const T> x, span<const T> y, size_t threads = 0) {
+  assert_is_integral(R);
+  assert_is_integral(T);
+  if (x.size() != y.size()) {
+    trap();
+  }
+
+  using Product = internal::wide_integer_t<2 * internal::bit_width_v<T>,
+                                           std::is_signed_v<T>>;
+  internal::widest_integer_t<std::is_signed_v<T>> total;
+  const bool overflow = internal::parallel_checked_accumulate<Product>(
+      x.size(), threads,
+      [x, y](size_t i) {
+        return static_cast<Product>(static_cast<Product>(x[i]) * y[i]);
+      },
+      &total);
+  return internal::checked_reduction_result<R>(
+      overflow, total, overflow_flags::mul | overflow_flags::add);
+}
+
+/// ### `parallel_trapping_add`
+///
+/// Like the batch `trapping_add`: computes `result[i] = x[i] + y[i]`.
+template <typename T>
+void parallel_trapping_add(span<const T> x,
+                           span<const T> y,
+                           span<T> result,
+                           size_t threads = 0) {
+  assert_is_integral(T);
+  internal::parallel_trapping(x, y, result, threads, overflow_flags::add,
+                              internal::batch_add<T>{});
+}
+
+/// ### `parallel_trapping_add`
+///
+/// Computes `result[i] = x[i] + y`.
+template <typename T>
+void parallel_trapping_add(span<const T> x,
+                           T y,
+                           span<T> result,
+                           size_t threads = 0) {
+  assert_is_integral(T);
+  internal::parallel_trapping(x, y, result, threads, overflow_flags::add,
+                              internal::batch_add<T>{});
+}
+
+/// ### `parallel_trapping_sub`
+///
+/// Like the batch `trapping_sub`: computes `result[i] = x[i] - y[i]`.
+template <typename T>
+void parallel_trapping_sub(span<const T> x,
+                           span<const T> y,
+                           span<T> result,
+                           size_t threads = 0) {
+  assert_is_integral(T);
+  internal::parallel_trapping(x, y, result, threads, overflow_flags::sub,
+                              internal::batch_sub<T>{});
+}
+
+/// ### `parallel_trapping_sub`
+///
+/// Computes `result[i] = x[i] - y`.
+template <typename T>
+void parallel_trapping_sub(span<const T> x,
+                           T y,
+                           span<T> result,
+                           size_t threads = 0) {
+  assert_is_integral(T);
+  internal::parallel_trapping(x, y, result, threads, overflow_flags::sub,
+                              internal::batch_sub<T>{});
+}
+
+/// ### `parallel_trapping_mul`
+///
+/// Like the batch `trapping_mul`: computes `result[i] = x[i] * y[i]`.
+template <typename T>
+void parallel_trapping_mul(span<const T> x,
+                           span<const T> y,
+                           span<T> result,
+                           size_t threads = 0) {
+  assert_is_integral(T);
+  internal::parallel_trapping(x, y, result, threads, overflow_flags::mul,
+                              internal::batch_mul<T>{});
+}
+
+/// ### `parallel_trapping_mul`
+///
+/// Computes `result[i] = x[i] * y`.
+template <typename T>
+void parallel_trapping_mul(span<const T> x,
+                           T y,
+                           span<T> result,
+                           size_t threads = 0) {
+  assert_is_integral(T);
+  internal::parallel_trapping(x, y, result, threads, overflow_flags::mul,
+                              internal::batch_mul<T>{});
+}
+
+/// ### `first_add_overflow`
+///
+/// Computes `result[i] = x[i] + y[i]` until some element overflows, and
+/// returns the index of the first that does (or `result.size()` if none
+/// does). This is always the smallest such index, however many threads there
+/// are. Elements before it are written; later ones may or may not be.
+template <typename T>
+[[nodiscard]] size_t first_add_overflow(span<const T> x,
+                                        span<const T> y,
+                                        span<T> result,
+                                        size_t threads = 0) {
+  assert_is_integral(T);
+  return internal::parallel_until_overflow(x, y, result, threads,
+                                           internal::batch_add<T>{});
+}
+
+/// ### `first_add_overflow`
+///
+/// Like the above, with `y` broadcast to every element.
+template <typename T>
+[[nodiscard]] size_t first_add_overflow(span<const T> x,
+                                        T y,
+                                        span<T> result,
+                                        size_t threads = 0) {
+  assert_is_integral(T);
+  return internal::parallel_until_overflow(x, y, result, threads,
+                                           internal::batch_add<T>{});
+}
+
+/// ### `first_sub_overflow`
+///
+/// Like `first_add_overflow`, for `result[i] = x[i] - y[i]`.
+template <typename T>
+[[nodiscard]] size_t first_sub_overflow(span<const T> x,
+                                        span<const T> y,
+                                        span<T> result,
+                                        size_t threads = 0) {
+  assert_is_integral(T);
+  return internal::parallel_until_overflow(x, y, result, threads,
+                                           internal::batch_sub<T>{});
+}
+
+/// ### `first_sub_overflow`
+///
+/// Like the above, with `y` broadcast to every element.
+template <typename T>
+[[nodiscard]] size_t first_sub_overflow(span<const T> x,
+                                        T y,
+                                        span<T> result,
+                                        size_t threads = 0) {
+  assert_is_integral(T);
+  return internal::parallel_until_overflow(x, y, result, threads,
+                                           internal::batch_sub<T>{});
+}
+
+/// ### `first_mul_overflow`
+///
+/// Like `first_add_overflow`, for `result[i] = x[i] * y[i]`.
+template <typename T>
+[[nodiscard]] size_t first_mul_overflow(span<const T> x,
+                                        span<const T> y,
+                                        span<T> result,
+                                        size_t threads = 0) {
+  assert_is_integral(T);
+  return internal::parallel_until_overflow(x, y, result, threads,
+                                           internal::batch_mul<T>{});
+}
+
+/// ### `first_mul_overflow`
+///
+/// Like the above, with `y` broadcast to every element.
+template <typename T>
+[[nodiscard]] size_t first_mul_overflow(span<const T> x,
+                                        T y,
+                                        span<T> result,
+                                        size_t threads = 0) {
+  assert_is_integral(T);
+  return internal::parallel_until_overflow(x, y, result, threads,
+                                           internal::batch_mul<T>{});
+}
+
+/// ### `parallel_checked_inclusive_scan`
+///
+/// Like `checked_inclusive_scan`. It reads `values` twice, so it is faster
+/// than `checked_inclusive_scan` only given several threads.
+template <typename R, typename T>
+[[nodiscard]] size_t parallel_checked_inclusive_scan(span<const T> values,
+                                                     span<R> result,
+                                                     size_t threads = 0) {
+  assert_is_integral(R);
+  assert_is_integral(T);
+  if (result.size() != values.size()) {
+    trap();
+  }
+  return internal::parallel_checked_scan(values, result, threads);
+}
+
+/// ### `parallel_checked_exclusive_scan`
+///
+/// Like `checked_exclusive_scan`, and `parallel_checked_inclusive_scan`.
+template <typename R, typename T>
+[[nodiscard]] size_t parallel_checked_exclusive_scan(span<const T> values,
+                                                     span<R> result,
+                                                     size_t threads = 0) {
+  assert_is_integral(R);
+  assert_is_integral(T);
+  if (result.size() != values.size() && result.size() != values.size() + 1) {
+    trap();
+  }
+  if (result.empty()) {
+    return 0;
+  }
+  result[0] = 0;
+  return 1 + internal::parallel_checked_scan(values.first(result.size() - 1),
+                                             result.subspan(1), threads);
+}
+
+}  // namespace integers
+
+#endif  // PARALLEL_H_
@@ -0,0 +1,216 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "parallel.h"
+#include "test_support.h"
+
+using namespace integers;
+using namespace std;
+
+namespace {
+
+using i8 = int8_t;
+using u8 = uint8_t;
+using i32 = int32_t;
+using u32 = uint32_t;
+using i64 = int64_t;
+using u64 = uint64_t;
+
+// Big enough to split across 4 threads, with a remainder.
+constexpr size_t kCount = 4 * internal::kParallelMinimumSlice + 3;
+
+void TestSlices() {
+  EXPECT(1 == internal::parallel_thread_count(0, 4));
+  EXPECT(1 == internal::parallel_thread_count(kCount, 1));
+  EXPECT(2 == internal::parallel_thread_count(kCount, 2));
+  EXPECT(4 == internal::parallel_thread_count(kCount, 64));
+  EXPECT(1 <= internal::parallel_thread_count(kCount, 0));
+
+  vector<u8> seen(kCount);
+  internal::parallel_slices(kCount, 4, [&](size_t, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      seen[i]++;
+    }
+  });
+  for (const u8 s : seen) {
+    EXPECT(1 == s);
+  }
+}
+
+template <typename T>
+void GenericTestSum() {
+  constexpr T max = numeric_limits<T>::max();
+
+  vector<T> v(kCount);
+  for (size_t i = 0; i < v.size(); i++) {
+    v[i] = static_cast<T>(i % 100);
+  }
+  const i64 expected = checked_sum<i64, T>(v);
+  for (const size_t threads :
+       {size_t{0}, size_t{1}, size_t{2}, size_t{3}, size_t{4}, size_t{7}}) {
+    EXPECT(expected == (parallel_checked_sum<i64, T>(v, threads)));
+  }
+
+  // Each thread's partial total overflows `R`, but the total does not.
+  vector<T> w(kCount, max);
+  if constexpr (is_signed_v<T>) {
+    for (size_t i = 0; i < w.size() / 2; i++) {
+      w[w.size() - 1 - i] = static_cast<T>(-max);
+    }
+    EXPECT(max == (parallel_checked_sum<T, T>(w, 4)));
+  }
+  EXPECT_DEATH((parallel_checked_sum<T, T>(vector<T>(kCount, max), 4)));
+}
+
+void TestSum() {
+  GenericTestSum<i8>();
+  GenericTestSum<u8>();
+  GenericTestSum<i32>();
+  GenericTestSum<u32>();
+  GenericTestSum<i64>();
+  GenericTestSum<u64>();
+
+  // Only the merge of the threads' totals overflows.
+  constexpr u64 umax = numeric_limits<u64>::max();
+  vector<u64> v(kCount, 0);
+  v[0] = umax;
+  v[kCount - 1] = umax;
+  EXPECT_DEATH((parallel_checked_sum<u64, u64>(v, 4)));
+}
+
+void TestDot() {
+  vector<i32> x(kCount);
+  vector<i32> y(kCount);
+  for (size_t i = 0; i < kCount; i++) {
+    x[i] = static_cast<i32>(i % 1000) - 500;
+    y[i] = static_cast<i32>(i % 7) - 3;
+  }
+  const i64 expected = checked_dot<i64, i32>(x, y);
+  for (const size_t threads : {size_t{1}, size_t{2}, size_t{4}}) {
+    EXPECT(expected == (parallel_checked_dot<i64, i32>(x, y, threads)));
+  }
+  EXPECT_DEATH((parallel_checked_dot<i64, i32>(x, vector<i32>(kCount - 1), 4)));
+
+  vector<i32> big(kCount, numeric_limits<i32>::min());
+  EXPECT_DEATH((parallel_checked_dot<i64, i32>(big, big, 4)));
+}
+
+void TestTrapping() {
+  vector<i32> x(kCount);
+  vector<i32> y(kCount);
+  for (size_t i = 0; i < kCount; i++) {
+    x[i] = static_cast<i32>(i);
+    y[i] = 2;
+  }
+  vector<i32> result(kCount);
+  parallel_trapping_add<i32>(x, y, result, 4);
+  EXPECT(kCount + 1 == static_cast<size_t>(result[kCount - 1]));
+  parallel_trapping_sub<i32>(x, 1, result, 4);
+  EXPECT(-1 == result[0]);
+  EXPECT(kCount - 2 == static_cast<size_t>(result[kCount - 1]));
+  parallel_trapping_mul<i32>(x, y, result, 4);
+  EXPECT(2 * (kCount - 1) == static_cast<size_t>(result[kCount - 1]));
+
+  x[kCount - 1] = numeric_limits<i32>::max();
+  EXPECT_DEATH((parallel_trapping_add<i32>(x, y, result, 4)));
+  EXPECT_DEATH((parallel_trapping_mul<i32>(x, 2, result, 4)));
+  x[0] = numeric_limits<i32>::min();
+  EXPECT_DEATH((parallel_trapping_sub<i32>(x, y, result, 4)));
+}
+
+void TestFirstOverflow() {
+  vector<u32> x(kCount, 1);
+  vector<u32> result(kCount);
+  EXPECT(kCount == first_add_overflow<u32>(x, 1, result, 4));
+  EXPECT(2 == result[kCount - 1]);
+
+  // The smallest index wins, though a later thread may find its own first.
+  x[kCount - 10] = numeric_limits<u32>::max();
+  x[kCount / 2 + 5] = numeric_limits<u32>::max();
+  for (const size_t threads : {size_t{1}, size_t{2}, size_t{3}, size_t{4}}) {
+    EXPECT(kCount / 2 + 5 == first_add_overflow<u32>(x, 1, result, threads));
+    EXPECT(2 == result[kCount / 2 + 4]);
+  }
+
+  vector<u32> y(kCount, 2);
+  EXPECT(kCount / 2 + 5 == first_mul_overflow<u32>(x, y, result, 4));
+  x[3] = 0;
+  EXPECT(3 == first_sub_overflow<u32>(x, vector<u32>(kCount, 1), result, 4));
+  EXPECT(3 == first_sub_overflow<u32>(x, 1, result, 4));
+  EXPECT(kCount == first_mul_overflow<u32>(x, 0, result, 4));
+  EXPECT(0 == result[kCount - 10]);
+}
+
+template <typename R, typename T>
+void TestScanPair(const vector<T>& values) {
+  vector<R> expected(values.size() + 1);
+  const size_t expected_bad = checked_exclusive_scan<R, T>(values, expected);
+  const ptrdiff_t good = static_cast<ptrdiff_t>(expected_bad);
+  for (const size_t threads : {size_t{1}, size_t{2}, size_t{3}, size_t{4}}) {
+    vector<R> result(values.size() + 1);
+    EXPECT(expected_bad ==
+           (parallel_checked_exclusive_scan<R, T>(values, result, threads)));
+    EXPECT(equal(result.begin(), result.begin() + good, expected.begin()));
+    EXPECT(expected_bad - 1 == (parallel_checked_inclusive_scan<R, T>(
+                                   values, span<R>(result).first(kCount),
+                                   threads)));
+    EXPECT(equal(result.begin(), result.begin() + good - 1,
+                 expected.begin() + 1));
+  }
+}
+
+void TestScan() {
+  vector<u32> sizes(kCount);
+  for (size_t i = 0; i < kCount; i++) {
+    sizes[i] = static_cast<u32>(i % 1000);
+  }
+  TestScanPair<u32, u32>(sizes);
+  TestScanPair<u64, u32>(sizes);
+  TestScanPair<i64, u32>(sizes);
+
+  // Overflow in each slice, and in the last slice only.
+  for (const size_t at : {size_t{5}, kCount / 4 + 1, kCount / 2, kCount - 1}) {
+    sizes[at] = numeric_limits<u32>::max() - 1000;
+    TestScanPair<u32, u32>(sizes);
+    TestScanPair<u64, u32>(sizes);
+  }
+
+  // Overflow that later elements bring back in range.
+  vector<i32> deltas(kCount, 1);
+  deltas[kCount / 3] = numeric_limits<i32>::max();
+  deltas[kCount / 3 + 1] = numeric_limits<i32>::min();
+  TestScanPair<i32, i32>(deltas);
+  TestScanPair<i64, i32>(deltas);
+  TestScanPair<u64, i32>(deltas);
+
+  vector<i64> big(kCount, numeric_limits<i64>::max() / 2);
+  TestScanPair<i64, i64>(big);
+  TestScanPair<u64, i64>(big);
+}
+
+}  // namespace
+
+int main() {
+  TestSlices();
+  TestSum();
+  TestDot();
+  TestTrapping();
+  TestFirstOverflow();
+  TestScan();
+}
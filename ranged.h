@@ -15,6 +15,7 @@
 #ifndef RANGED_H_
 #define RANGED_H_
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -23,6 +24,7 @@
 #include <type_traits>
 
 #include "is_integral.h"
+#include "span.h"
 #include "trap.h"
 
 namespace integers {
@@ -59,4 +61,60 @@ class ranged {
 
 }  // namespace integers
 
+namespace internal {
+
+template <typename Ranged>
+struct ranged_traits;
+
+template <typename T, T Min, T Max>
+struct ranged_traits<integers::ranged<T, Min, Max>> {
+  using value_type = T;
+  static constexpr T min = Min;
+  static constexpr T max = Max;
+};
+
+// Returns true if every element of `values` is in `[Min, Max]`. Offsetting by
+// `Min` in unsigned arithmetic maps that range to `[0, Max - Min]` and
+// everything else above it, so the check is a maximum reduction, which
+// compilers vectorize.
+template <typename T, T Min, T Max>
+bool all_between(integers::span<const T> values) {
+  using U = std::make_unsigned_t<T>;
+  U highest = 0;
+  for (const T x : values) {
+    highest = std::max(highest,
+                       static_cast<U>(static_cast<U>(x) - static_cast<U>(Min)));
+  }
+  return highest <= static_cast<U>(static_cast<U>(Max) - static_cast<U>(Min));
+}
+
+}  // namespace internal
+
+namespace integers {
+
+/// ### `validate_as`
+///
+/// Checks that every element of `values` is in range for `R`, which is some
+/// `ranged<T, Min, Max>`, and returns a view of the same memory as a span of
+/// `R`. If any element is out of range, this function `trap`s.
+///
+///   span<const uint8_t> wire = ...;
+///   const auto opcodes = validate_as<ranged<uint8_t, 0, 11>>(wire);
+///
+/// This is one branch-free pass over `values`, rather than a branch and a copy
+/// per element. The view aliases `values`, so it is valid only while
+/// `values` is, and only while no one writes an out-of-range value there.
+template <typename R>
+span<const R> validate_as(
+    span<const typename internal::ranged_traits<R>::value_type> values) {
+  using Traits = internal::ranged_traits<R>;
+  if (!internal::all_between<typename Traits::value_type, Traits::min,
+                             Traits::max>(values)) {
+    trap();
+  }
+  return internal::span_cast<const R>(values);
+}
+
+}  // namespace integers
+
 #endif  // RANGED_H_
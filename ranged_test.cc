@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <iostream>
+#include <vector>
 
 #include "ranged.h"
 #include "test_support.h"
@@ -30,4 +31,30 @@ int main() {
     ranged<int, 0, 256> goat;
     // EXPECT_DEATH(goat{512});
   }
+  {
+    using opcode = ranged<uint8_t, 0, 11>;
+    const vector<uint8_t> wire{0, 3, 11, 7};
+    const span<const opcode> opcodes = validate_as<opcode>(wire);
+    EXPECT(wire.size() == opcodes.size());
+    EXPECT(static_cast<const void*>(wire.data()) == opcodes.data());
+    EXPECT(11 == opcodes[2]);
+    EXPECT(validate_as<opcode>(span<const uint8_t>()).empty());
+    EXPECT_DEATH(
+        static_cast<void>(validate_as<opcode>(vector<uint8_t>{0, 12})));
+  }
+  {
+    using small = ranged<int16_t, -5, 5>;
+    vector<int16_t> values(1000, 5);
+    values[500] = -5;
+    EXPECT(-5 == validate_as<small>(values)[500]);
+    values[999] = 6;
+    EXPECT_DEATH(static_cast<void>(validate_as<small>(values)));
+    values[999] = -6;
+    EXPECT_DEATH(static_cast<void>(validate_as<small>(values)));
+
+    // A range of every value accepts everything.
+    using any = ranged<int8_t, -128, 127>;
+    const vector<int8_t> extremes{-128, 127, 0};
+    EXPECT(-128 == validate_as<any>(extremes)[0]);
+  }
 }
@@ -0,0 +1,315 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef REDUCE_H_
+#define REDUCE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+#if __has_include(<sys/uio.h>)
+#include <sys/uio.h>
+#define INTEGERS_HAVE_IOVEC 1
+#endif
+
+#include "is_integral.h"
+#include "overflow_status.h"
+#include "span.h"
+#include "trap.h"
+#include "trapping.h"
+#include "wide.h"
+
+namespace internal {
+
+// The widest integer type available with the given signedness, in which
+// reductions keep their running totals.
+#if defined(INTEGERS_HAVE_INT128)
+template <bool Signed>
+using widest_integer_t = std::conditional_t<Signed, int128_t, uint128_t>;
+#else
+template <bool Signed>
+using widest_integer_t = std::conditional_t<Signed, int64_t, uint64_t>;
+#endif
+
+template <typename T>
+constexpr int bit_width_v =
+    std::numeric_limits<T>::digits + std::is_signed_v<T>;
+
+// The number of terms that a reduction accumulates in 64-bit partial sums
+// before merging them into the total. Terms (or, for 64-bit terms, their
+// high and low halves) are at most 2**32 in magnitude, so 2**31 of them
+// cannot overflow a 64-bit partial sum. This is a proof, not a check: the
+// inner loops have no overflow checks at all, which is what lets compilers
+// vectorize them.
+constexpr size_t kReductionChunk = size_t{1} << 31;
+
+// Stores the sum of `term(i)` for `i` in `[0, count)` in `*total`, and returns
+// true if it overflowed `Total`. `Term` is the type that `term` returns.
+//
+// Terms of up to 32 bits accumulate in 64-bit partial sums, one per chunk.
+// 64-bit terms, if there is a 128-bit type to hold the total, accumulate as
+// separate sums of their high and low 32-bit halves. Only the merging of
+// partial sums into the total is checked. Otherwise, each addition is checked.
+template <typename Term, typename F>
+bool checked_accumulate(size_t count,
+                        F term,
+                        widest_integer_t<is_signed_wide_v<Term>>* total) {
+  using Total = widest_integer_t<is_signed_wide_v<Term>>;
+  using Word = std::conditional_t<is_signed_wide_v<Term>, int64_t, uint64_t>;
+
+  *total = 0;
+  bool overflow = false;
+  if constexpr (bit_width_v<Term> <= 32) {
+    for (size_t start = 0; start < count; start += kReductionChunk) {
+      const size_t end = start + std::min(kReductionChunk, count - start);
+      Word partial = 0;
+      for (size_t i = start; i < end; i++) {
+        partial += static_cast<Word>(term(i));
+      }
+      overflow |= wide_add_overflow(*total, static_cast<Total>(partial), total);
+    }
+  } else if constexpr (bit_width_v<Term> <= 64 && sizeof(Total) > 8) {
+    for (size_t start = 0; start < count; start += kReductionChunk) {
+      const size_t end = start + std::min(kReductionChunk, count - start);
+      Word high = 0;
+      uint64_t low = 0;
+      for (size_t i = start; i < end; i++) {
+        const Term x = term(i);
+        high += static_cast<Word>(x >> 32);
+        low += static_cast<uint32_t>(x);
+      }
+      overflow |= wide_add_overflow(
+          *total, static_cast<Total>(high) * (Total{1} << 32), total);
+      overflow |= wide_add_overflow(*total, static_cast<Total>(low), total);
+    }
+  } else {
+    for (size_t i = 0; i < count; i++) {
+      overflow |= wide_add_overflow(*total, static_cast<Total>(term(i)), total);
+    }
+  }
+  return overflow;
+}
+
+// Converts the `total` of a reduction to `R`. Traps (or, in sticky mode,
+// records `flag`) if the reduction overflowed or `R` cannot represent
+// `total`.
+template <typename R, typename Total>
+R checked_reduction_result(bool overflow,
+                           Total total,
+                           integers::overflow_flags flag) {
+  const bool bad = overflow || !wide_in_range<R>(total);
+#if defined(INTEGERS_STICKY_OVERFLOW)
+  integers::record_overflow(bad, flag);
+#else
+  static_cast<void>(flag);
+  if (bad) {
+    trap();
+  }
+#endif
+  return static_cast<R>(total);
+}
+
+// Stores the running totals of `values`, starting from `total`, in `result`
+// (which is as big), until one overflows `R`. Returns its index, or
+// `values.size()`.
+//
+// This is a plain loop of checked additions. Each depends on the one before,
+// but they take about a cycle each, which is as fast as computing totals a
+// vector at a time (with shuffles) turns out to be, and faster than memory
+// beyond the L2 cache.
+template <typename R, typename T>
+size_t checked_scan(integers::span<const T> values,
+                    integers::span<R> result,
+                    R total) {
+  for (size_t i = 0; i < values.size(); i++) {
+    if (integers::add_overflow(total, values[i], &total)) {
+      return i;
+    }
+    result[i] = total;
+  }
+  return values.size();
+}
+
+}  // namespace internal
+
+namespace integers {
+
+/// ## Checked Reductions
+///
+/// These functions reduce whole spans with one overflow check at the end,
+/// rather than one per operation (as e.g. `std::accumulate` over
+/// `trapping<T>`s does). They accumulate in a type chosen at compile time to
+/// be wide enough that the accumulation provably cannot overflow, and then
+/// `trap` if `R` cannot represent the result. (If `INTEGERS_STICKY_OVERFLOW`
+/// is defined, they instead record the overflow in the sticky overflow status
+/// and return the truncated result.)
+///
+/// For inputs of up to 32 bits (and for 64-bit inputs, given a compiler with
+/// `__int128`), the inner loops are unchecked, branch-free, 64-bit additions
+/// that compilers vectorize.
+///
+/// You must give both `R` and `T` when passing containers:
+///
+///   std::vector<int32_t> column = ...;
+///   int64_t total = checked_sum<int64_t, int32_t>(column);
+///
+/// ### `checked_sum`
+///
+/// Returns the sum of `values`.
+template <typename R, typename T>
+R checked_sum(span<const T> values) {
+  assert_is_integral(R);
+  assert_is_integral(T);
+
+  internal::widest_integer_t<std::is_signed_v<T>> total;
+  const bool overflow = internal::checked_accumulate<T>(
+      values.size(), [values](size_t i) { return values[i]; }, &total);
+  return internal::checked_reduction_result<R>(overflow, total,
+                                               overflow_flags::add);
+}
+
+/// ### `checked_dot`
+///
+/// Returns the dot product of `x` and `y`, which must be the same size. (If
+/// not, this function `trap`s.) The products are exact, in a type twice as
+/// wide as `T`.
+template <typename R, typename T>
+R checked_dot(span<const T> x, span<const T> y) {
+  assert_is_integral(R);
+  assert_is_integral(T);
+  if (x.size() != y.size()) {
+    trap();
+  }
+
+  using Product = internal::wide_integer_t<2 * internal::bit_width_v<T>,
+                                           std::is_signed_v<T>>;
+  internal::widest_integer_t<std::is_signed_v<T>> total;
+  const bool overflow = internal::checked_accumulate<Product>(
+      x.size(),
+      [x, y](size_t i) {
+        return static_cast<Product>(static_cast<Product>(x[i]) * y[i]);
+      },
+      &total);
+  return internal::checked_reduction_result<R>(
+      overflow, total, overflow_flags::mul | overflow_flags::add);
+}
+
+/// ### `checked_sum_of`
+///
+/// Returns the sum of `projection(x)` for each `x` in `values`. `projection`
+/// is anything `std::invoke` can call with a `const T&` and that returns an
+/// integer, such as a lambda or a pointer to a data member:
+///
+///   struct Record { uint32_t size; ... };
+///   std::vector<Record> records = ...;
+///   uint64_t total = checked_sum_of<uint64_t, Record>(records, &Record::size);
+///
+/// Projections of fields of structs vectorize less well than `checked_sum`
+/// over a packed array (the loads are strided), but the loop is still free
+/// of branches and overflow checks.
+template <typename R, typename T, typename Projection>
+R checked_sum_of(span<const T> values, Projection projection) {
+  assert_is_integral(R);
+  using Term = std::remove_cv_t<std::remove_reference_t<
+      std::invoke_result_t<Projection&, const T&>>>;
+  assert_is_integral(Term);
+
+  internal::widest_integer_t<std::is_signed_v<Term>> total;
+  const bool overflow = internal::checked_accumulate<Term>(
+      values.size(),
+      [values, &projection](size_t i) -> Term {
+        return std::invoke(projection, values[i]);
+      },
+      &total);
+  return internal::checked_reduction_result<R>(overflow, total,
+                                               overflow_flags::add);
+}
+
+#if defined(INTEGERS_HAVE_IOVEC)
+
+/// ### `checked_total_length`
+///
+/// Returns the sum of the `iov_len`s of `buffers`, as for `writev`, `readv`,
+/// and `sendmsg`. A corrupt length makes the sum `trap` rather than wrap
+/// around to a small total. Those calls also fail if the total exceeds
+/// `SSIZE_MAX`; to check that too, give `R` as `ssize_t`.
+template <typename R = size_t>
+R checked_total_length(span<const iovec> buffers) {
+  return checked_sum_of<R>(buffers, &iovec::iov_len);
+}
+
+#endif  // defined(INTEGERS_HAVE_IOVEC)
+
+/// ## Checked Scans
+///
+/// These functions compute running totals, such as the offset tables that
+/// file writers and graph builders make from arrays of record sizes. Rather
+/// than `trap`, they return the index of the first total that `R` cannot
+/// represent (or `result.size()` if there is none), so that callers can report
+/// which record did not fit. Totals before that index are written; the later
+/// entries of `result` are unspecified. (These functions leave them
+/// unchanged, but the parallel versions in parallel.h may write some of
+/// them.)
+///
+///   std::vector<uint32_t> sizes = ...;
+///   std::vector<uint32_t> offsets(sizes.size() + 1);
+///   if (checked_exclusive_scan<uint32_t, uint32_t>(sizes, offsets) !=
+///       offsets.size()) {
+///     // The file is too big for 32-bit offsets.
+///   }
+///
+/// ### `checked_inclusive_scan`
+///
+/// Computes `result[i] = values[0] + ... + values[i]`. `result` must be the
+/// same size as `values`. (If not, this function `trap`s.)
+template <typename R, typename T>
+[[nodiscard]] size_t checked_inclusive_scan(span<const T> values,
+                                            span<R> result) {
+  assert_is_integral(R);
+  assert_is_integral(T);
+  if (result.size() != values.size()) {
+    trap();
+  }
+  return internal::checked_scan(values, result, R{0});
+}
+
+/// ### `checked_exclusive_scan`
+///
+/// Computes `result[i] = values[0] + ... + values[i - 1]`, so `result[0]` is
+/// 0. `result` must be the same size as `values`, or one bigger to also hold
+/// the sum of all of `values`. (If not, this function `trap`s.)
+template <typename R, typename T>
+[[nodiscard]] size_t checked_exclusive_scan(span<const T> values,
+                                            span<R> result) {
+  assert_is_integral(R);
+  assert_is_integral(T);
+  if (result.size() != values.size() && result.size() != values.size() + 1) {
+    trap();
+  }
+  if (result.empty()) {
+    return 0;
+  }
+  result[0] = 0;
+  return 1 + internal::checked_scan(values.first(result.size() - 1),
+                                    result.subspan(1), R{0});
+}
+
+}  // namespace integers
+
+#endif  // REDUCE_H_
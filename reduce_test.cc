@@ -0,0 +1,280 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "reduce.h"
+#include "test_support.h"
+
+using namespace integers;
+using namespace std;
+
+namespace {
+
+using i8 = int8_t;
+using u8 = uint8_t;
+using i16 = int16_t;
+using u16 = uint16_t;
+using i32 = int32_t;
+using u32 = uint32_t;
+using i64 = int64_t;
+using u64 = uint64_t;
+
+template <typename T>
+void GenericTestSum() {
+  constexpr T max = numeric_limits<T>::max();
+  constexpr T min = numeric_limits<T>::min();
+
+  EXPECT(0 == (checked_sum<i64, T>(span<const T>())));
+  vector<T> v(1000);
+  for (size_t i = 0; i < v.size(); i++) {
+    v[i] = static_cast<T>(i % 100);
+  }
+  EXPECT(49500 == (checked_sum<i64, T>(v)));
+  EXPECT(49500 == (checked_sum<u32, T>(v)));
+
+  // The total may pass through values that `R` cannot represent.
+  vector<T> w = {max, max, max, 1};
+  if constexpr (is_signed_v<T>) {
+    w = {max, max, static_cast<T>(-max), static_cast<T>(-max), 1};
+    EXPECT(1 == (checked_sum<i8, T>(w)));
+    w = {min, min, 1};
+    EXPECT_DEATH((checked_sum<T, T>(w)));
+  } else {
+    w = {max, max, 1};
+    EXPECT_DEATH((checked_sum<T, T>(w)));
+  }
+  EXPECT_DEATH((checked_sum<i8, T>(vector<T>{100, 28})));
+}
+
+template <class... T>
+void CallGenericTestSum() {
+  (GenericTestSum<T>(), ...);
+}
+
+void TestSum() {
+  CallGenericTestSum<i8, u8, i16, u16, i32, u32, i64, u64>();
+}
+
+template <typename T>
+void GenericTestDot() {
+  constexpr T max = numeric_limits<T>::max();
+
+  EXPECT(0 == (checked_dot<i64, T>(span<const T>(), span<const T>())));
+  vector<T> x(1000);
+  vector<T> y(1000);
+  i64 expected = 0;
+  for (size_t i = 0; i < x.size(); i++) {
+    x[i] = static_cast<T>(i % 10);
+    y[i] = static_cast<T>(i % 7);
+    expected += static_cast<i64>(x[i]) * static_cast<i64>(y[i]);
+  }
+  EXPECT(expected == (checked_dot<i64, T>(x, y)));
+
+  // Products are exact, even when `T` cannot represent them.
+  const vector<T> big = {max, max};
+  EXPECT(max == (checked_dot<T, T>(vector<T>{1, 0}, big)));
+  if constexpr (sizeof(T) < sizeof(i32)) {
+    EXPECT(2 * i64{max} * i64{max} == (checked_dot<i64, T>(big, big)));
+  }
+  EXPECT_DEATH((checked_dot<T, T>(big, big)));
+
+  // The sizes differ.
+  EXPECT_DEATH((checked_dot<i64, T>(x, span<const T>(y).first(999))));
+}
+
+template <class... T>
+void CallGenericTestDot() {
+  (GenericTestDot<T>(), ...);
+}
+
+void TestDot() {
+  CallGenericTestDot<i8, u8, i16, u16, i32, u32, i64, u64>();
+}
+
+void TestSigned() {
+  constexpr i64 i64_max = numeric_limits<i64>::max();
+  constexpr i64 i64_min = numeric_limits<i64>::min();
+  constexpr i32 i32_min = numeric_limits<i32>::min();
+
+  // The 64-bit path splits terms into high and low halves.
+  EXPECT(-3 == (checked_sum<i64, i64>(vector<i64>{-1, -1, -1})));
+  EXPECT(i64_min == (checked_sum<i64, i64>(vector<i64>{i64_min})));
+  EXPECT(i64_max ==
+         (checked_sum<i64, i64>(vector<i64>{i64_max, i64_min, i64_max, 1})));
+  EXPECT_DEATH((checked_sum<i64, i64>(vector<i64>{i64_min, -1})));
+  EXPECT(i64{i32_min} * i32_min ==
+         (checked_dot<i64, i32>(vector<i32>{i32_min}, vector<i32>{i32_min})));
+  EXPECT_DEATH((checked_dot<i64, i32>(vector<i32>{i32_min, i32_min},
+                                      vector<i32>{i32_min, i32_min})));
+  EXPECT(-6 == (checked_dot<i64, i32>(vector<i32>{-1, 2}, vector<i32>{2, -2})));
+  EXPECT(numeric_limits<u64>::max() - 1 ==
+         (checked_sum<u64, u64>(
+             vector<u64>{numeric_limits<u64>::max() - 3, 2})));
+}
+
+struct Record {
+  u8 kind;
+  i32 delta;
+  u64 size;
+};
+
+void TestSumOf() {
+  vector<Record> records(1000);
+  i64 expected_delta = 0;
+  u32 expected_kind = 0;
+  for (size_t i = 0; i < records.size(); i++) {
+    records[i] = {static_cast<u8>(i), static_cast<i32>(i) - 600, i * 1000};
+    expected_delta += records[i].delta;
+    expected_kind += records[i].kind;
+  }
+  EXPECT(expected_delta ==
+         (checked_sum_of<i64, Record>(records, &Record::delta)));
+  EXPECT(999 * 1000 / 2 * 1000 ==
+         (checked_sum_of<u64, Record>(records, &Record::size)));
+  EXPECT(2 * expected_kind ==
+         (checked_sum_of<u32, Record>(
+             records, [](const Record& r) { return 2 * u32{r.kind}; })));
+  EXPECT_DEATH((checked_sum_of<u16, Record>(records, &Record::kind)));
+  EXPECT_DEATH((checked_sum_of<i16, Record>(records, &Record::delta)));
+
+  records[7].size = numeric_limits<u64>::max() - 1000;
+  EXPECT_DEATH((checked_sum_of<u64, Record>(records, &Record::size)));
+  EXPECT(0 == (checked_sum_of<u64, Record>(span<const Record>(),
+                                          &Record::size)));
+
+#if defined(INTEGERS_HAVE_IOVEC)
+  char data[16];
+  vector<iovec> buffers(300, iovec{data, sizeof(data)});
+  EXPECT(300 * sizeof(data) == checked_total_length(buffers));
+  EXPECT(300 * 16 == checked_total_length<ssize_t>(buffers));
+  buffers[100].iov_len = numeric_limits<size_t>::max() - 100;
+  EXPECT_DEATH(checked_total_length(buffers));
+  buffers[100].iov_len = numeric_limits<size_t>::max() / 2;
+  EXPECT(numeric_limits<size_t>::max() / 2 + 299 * 16 ==
+         checked_total_length(buffers));
+  EXPECT_DEATH(checked_total_length<ssize_t>(buffers));
+#endif
+}
+
+// Checks the scans against a loop of checked additions, for inputs that
+// overflow `R` (if at all) at various indexes.
+template <typename R, typename T>
+void TestScanPair() {
+  constexpr T max = numeric_limits<T>::max();
+  constexpr T min = numeric_limits<T>::min();
+  for (size_t count :
+       {size_t{0}, size_t{1}, size_t{7}, size_t{33}, size_t{100}}) {
+    for (int pattern = 0; pattern < 4; pattern++) {
+      vector<T> values(count);
+      for (size_t i = 0; i < count; i++) {
+        switch (pattern) {
+          case 0:
+            values[i] = static_cast<T>(i % 7);
+            break;
+          case 1:
+            values[i] = static_cast<T>(max / 16 + static_cast<T>(i % 3));
+            break;
+          case 2:
+            values[i] = i % 2 == 0 ? max : min;
+            break;
+          default:
+            values[i] = static_cast<T>(i == count / 2 ? max : 1);
+        }
+      }
+
+      vector<R> expected(count);
+      size_t expected_bad = count;
+      R total = 0;
+      for (size_t i = 0; i < count; i++) {
+        if (add_overflow(total, values[i], &total)) {
+          expected_bad = i;
+          break;
+        }
+        expected[i] = total;
+      }
+
+      const ptrdiff_t good = static_cast<ptrdiff_t>(expected_bad);
+      vector<R> result(count);
+      EXPECT(expected_bad == (checked_inclusive_scan<R, T>(values, result)));
+      EXPECT(equal(result.begin(), result.begin() + good, expected.begin()));
+
+      vector<R> offsets(count + 1);
+      EXPECT(expected_bad + 1 ==
+             (checked_exclusive_scan<R, T>(values, offsets)));
+      EXPECT(0 == offsets[0]);
+      EXPECT(equal(offsets.begin() + 1, offsets.begin() + 1 + good,
+                   expected.begin()));
+    }
+  }
+}
+
+template <typename R, typename... T>
+void CallTestScanPair() {
+  (TestScanPair<R, T>(), ...);
+}
+
+template <typename... R>
+void CallTestScanPairs() {
+  (CallTestScanPair<R, i8, u8, i16, u16, i32, u32, i64, u64>(), ...);
+}
+
+void TestScan() {
+  CallTestScanPairs<i8, u8, i16, u16, i32, u32, i64, u64>();
+
+  // Offset tables.
+  const vector<u32> sizes = {10, 20, 30};
+  vector<u32> offsets(4);
+  EXPECT(4 == (checked_exclusive_scan<u32, u32>(sizes, offsets)));
+  EXPECT((vector<u32>{0, 10, 30, 60}) == offsets);
+  EXPECT(3 == (checked_exclusive_scan<u32, u32>(
+                   sizes, span<u32>(offsets).first(3))));
+  EXPECT(30 == offsets[2]);
+  EXPECT(0 == (checked_exclusive_scan<u32, u32>(span<const u32>(),
+                                                span<u32>())));
+  EXPECT(1 == (checked_exclusive_scan<u32, u32>(span<const u32>(),
+                                                span<u32>(offsets).first(1))));
+
+  vector<u32> big(1000, numeric_limits<u32>::max() / 500);
+  vector<u32> big_offsets(1001);
+  EXPECT(501 == (checked_exclusive_scan<u32, u32>(big, big_offsets)));
+  vector<u64> wide_offsets(1001);
+  EXPECT(1001 == (checked_exclusive_scan<u64, u32>(big, wide_offsets)));
+  EXPECT(1000 * u64{big[0]} == wide_offsets[1000]);
+
+  // A negative element may bring the total back in range, but the scan
+  // reports the first total out of range.
+  vector<i8> running(3);
+  EXPECT(1 == (checked_inclusive_scan<i8, i8>(vector<i8>{100, 100, -100},
+                                              running)));
+  EXPECT(100 == running[0]);
+
+  EXPECT_DEATH(
+      static_cast<void>(checked_inclusive_scan<u32, u32>(sizes, offsets)));
+  EXPECT_DEATH(static_cast<void>(checked_exclusive_scan<u32, u32>(
+      sizes, span<u32>(offsets).first(2))));
+}
+
+}  // namespace
+
+int main() {
+  TestSum();
+  TestDot();
+  TestSigned();
+  TestSumOf();
+  TestScan();
+}
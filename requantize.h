@@ -0,0 +1,111 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef REQUANTIZE_H_
+#define REQUANTIZE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "clamping.h"
+#include "is_integral.h"
+#include "span.h"
+#include "trap.h"
+
+namespace internal {
+
+// The largest shift for which `requantize` is exact: the product of two
+// `int32_t`s has magnitude at most 2^62, so adding half of 2^62 to it cannot
+// overflow `int64_t`.
+constexpr int kMaxRequantizeShift = 62;
+
+// Computes `requantize` without checking `shift`.
+//
+// The product is exact in 64 bits. Adding half of `2^shift` and then shifting
+// right (which rounds down) rounds half up; subtracting 1 first from negative
+// products, unless `shift` is 0, makes that half away from zero. There are no
+// branches, so loops of this vectorize (e.g. to `vpmuldq`, `vpsraq`, and
+// min/max on x86).
+template <typename R>
+R unchecked_requantize(int32_t accumulator,
+                       int32_t multiplier,
+                       int shift,
+                       int32_t zero_point) {
+  const int64_t product = int64_t{accumulator} * int64_t{multiplier};
+  const int64_t half = (int64_t{1} << shift) >> 1;
+  const int64_t bias = half - int64_t{(product < 0) & (half != 0)};
+  return integers::clamping_cast<R>(((product + bias) >> shift) +
+                                    int64_t{zero_point});
+}
+
+}  // namespace internal
+
+namespace integers {
+
+/// ## Requantization
+///
+/// Quantized inference accumulates products of `int8_t` (or `uint8_t`) values
+/// in `int32_t`s, and then requantizes each accumulator back to 8 bits:
+///
+///   result = clamp(round(accumulator * multiplier / 2^shift) + zero_point)
+///
+/// where `multiplier / 2^shift` approximates the real-valued ratio of the
+/// input and output scales. These functions compute that exactly, rounding
+/// half away from zero and clamping to `R`’s range. They `trap` if `shift` is
+/// not in [0, 62].
+///
+/// ### `requantize`
+///
+/// Requantizes one accumulator to `R`. This is the reference for the batch
+/// version, which computes the same results.
+template <typename R>
+R requantize(int32_t accumulator,
+             int32_t multiplier,
+             int shift,
+             int32_t zero_point) {
+  assert_is_integral(R);
+  if (shift < 0 || shift > internal::kMaxRequantizeShift) {
+    trap();
+  }
+  return internal::unchecked_requantize<R>(accumulator, multiplier, shift,
+                                           zero_point);
+}
+
+/// ### `requantize`
+///
+/// Computes `result[i] = requantize<R>(accumulators[i], multiplier, shift,
+/// zero_point)`. The loop has no branches, so compilers vectorize it for
+/// whatever instruction set you target (e.g. AVX2 or AVX-512 with
+/// `-march=native`). `accumulators` must have at least as many elements as
+/// `result`; if not, this function `trap`s. You must give `R` explicitly.
+template <typename R>
+void requantize(span<const int32_t> accumulators,
+                int32_t multiplier,
+                int shift,
+                int32_t zero_point,
+                span<R> result) {
+  assert_is_integral(R);
+  if (shift < 0 || shift > internal::kMaxRequantizeShift ||
+      accumulators.size() < result.size()) {
+    trap();
+  }
+  for (size_t i = 0; i < result.size(); i++) {
+    result[i] = internal::unchecked_requantize<R>(accumulators[i], multiplier,
+                                                  shift, zero_point);
+  }
+}
+
+}  // namespace integers
+
+#endif  // REQUANTIZE_H_
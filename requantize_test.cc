@@ -0,0 +1,146 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "requantize.h"
+#include "test_support.h"
+
+using namespace integers;
+using namespace std;
+
+namespace {
+
+using i8 = int8_t;
+using u8 = uint8_t;
+using i16 = int16_t;
+using i32 = int32_t;
+using i64 = int64_t;
+using u64 = uint64_t;
+
+// Computes the requantization with division and branches, the obvious way.
+template <typename R>
+R Reference(i32 accumulator, i32 multiplier, int shift, i32 zero_point) {
+  const i64 product = i64{accumulator} * multiplier;
+  const i64 divisor = i64{1} << shift;
+  i64 quotient = product / divisor;
+  const i64 remainder = product % divisor;
+  if (2 * (remainder < 0 ? -remainder : remainder) >= divisor) {
+    quotient += product < 0 ? -1 : 1;
+  }
+  return static_cast<R>(std::clamp<i64>(quotient + zero_point,
+                                        numeric_limits<R>::min(),
+                                        numeric_limits<R>::max()));
+}
+
+void TestRounding() {
+  // 5 / 2, -5 / 2, 3 / 4, -3 / 4, and 1 / 4 round half away from zero.
+  EXPECT(3 == requantize<i8>(5, 1, 1, 0));
+  EXPECT(-3 == requantize<i8>(-5, 1, 1, 0));
+  EXPECT(1 == requantize<i8>(3, 1, 2, 0));
+  EXPECT(-1 == requantize<i8>(-3, 1, 2, 0));
+  EXPECT(0 == requantize<i8>(1, 1, 2, 0));
+  EXPECT(0 == requantize<i8>(-1, 1, 2, 0));
+  EXPECT(-1 == requantize<i8>(-2, 1, 2, 0));
+
+  // Shifting by 0 does not round.
+  EXPECT(-7 == requantize<i8>(-7, 1, 0, 0));
+
+  // The zero point is added after rounding, and then the result saturates.
+  EXPECT(10 == requantize<i8>(-5, 1, 1, 13));
+  EXPECT(127 == requantize<i8>(1000, 3, 2, 0));
+  EXPECT(-128 == requantize<i8>(-1000, 3, 2, 0));
+  EXPECT(0 == requantize<u8>(-1000, 3, 2, 128));
+  EXPECT(255 == requantize<u8>(1000, 3, 2, 128));
+  EXPECT(128 == requantize<u8>(0, 3, 2, 128));
+
+  // The product is exact even at the extremes.
+  constexpr i32 min = numeric_limits<i32>::min();
+  constexpr i32 max = numeric_limits<i32>::max();
+  EXPECT(1 == requantize<i8>(min, min, 62, 0));
+  EXPECT(-1 == requantize<i8>(min, max, 62, 0));
+  EXPECT(-1 == requantize<i8>(max, min, 62, 0));
+  EXPECT(32767 == requantize<i16>(max, max, 47, 0));
+  EXPECT(16384 == requantize<i16>(max, max, 48, 0));
+  EXPECT(8192 == requantize<i16>(max, max, 49, 0));
+
+  EXPECT_DEATH(static_cast<void>(requantize<i8>(1, 1, -1, 0)));
+  EXPECT_DEATH(static_cast<void>(requantize<i8>(1, 1, 63, 0)));
+}
+
+template <typename R>
+void GenericTestBatch() {
+  const i32 accumulators[] = {0,
+                              1,
+                              -1,
+                              127,
+                              -128,
+                              1 << 20,
+                              -(1 << 20),
+                              12345678,
+                              -12345678,
+                              numeric_limits<i32>::max(),
+                              numeric_limits<i32>::min()};
+  const i32 multipliers[] = {1, 3, 1 << 30, 1518500250, -7,
+                             numeric_limits<i32>::max()};
+  const int shifts[] = {0, 1, 7, 31, 38, 62};
+  const i32 zero_points[] = {0, -3, 128};
+
+  vector<i32> values;
+  u64 state = 1;
+  for (int i = 0; i < 1000; i++) {
+    state = state * 6364136223846793005u + 1442695040888963407u;
+    values.push_back(static_cast<i32>(state >> 32));
+  }
+  values.insert(values.end(), begin(accumulators), end(accumulators));
+
+  vector<R> result(values.size());
+  for (const i32 multiplier : multipliers) {
+    for (const int shift : shifts) {
+      for (const i32 zero_point : zero_points) {
+        requantize<R>(values, multiplier, shift, zero_point, result);
+        for (size_t i = 0; i < values.size(); i++) {
+          const R expected =
+              Reference<R>(values[i], multiplier, shift, zero_point);
+          EXPECT(expected ==
+                 requantize<R>(values[i], multiplier, shift, zero_point));
+          EXPECT(expected == result[i]);
+        }
+      }
+    }
+  }
+
+  EXPECT_DEATH(requantize<R>(values, 1, 63, 0, result));
+  result.push_back(0);
+  EXPECT_DEATH(requantize<R>(values, 1, 0, 0, result));
+}
+
+template <class... R>
+void CallGenericTestBatch() {
+  (GenericTestBatch<R>(), ...);
+}
+
+void TestBatch() {
+  CallGenericTestBatch<i8, u8, i16>();
+}
+
+}  // namespace
+
+int main() {
+  TestRounding();
+  TestBatch();
+}
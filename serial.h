@@ -0,0 +1,262 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SERIAL_H_
+#define SERIAL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <limits>
+#include <ostream>
+#include <type_traits>
+
+#include "in_range.h"
+#include "is_integral.h"
+#include "span.h"
+#include "trap.h"
+#include "wrapping.h"
+
+namespace integers {
+
+/// ## `serial<T>`
+///
+/// This template class implements serial number arithmetic (RFC 1982), for
+/// sequence numbers, generation counters, and ring positions that wrap around
+/// and are compared by which is ahead of the other, not by their values. `T`
+/// must be unsigned.
+///
+/// Serial numbers increase by wrapping addition of at most half their range,
+/// less 1 (`kMaxIncrement`); larger increments `trap`. `a < b` if `b` is
+/// ahead of `a` by less than half the range: that is, if `b - a`, wrapped,
+/// is in (0, 2^(bits - 1)). This is not a total order: numbers exactly half
+/// the range apart are neither less nor greater than each other.
+///
+///   serial<uint32_t> sent{0xFFFFFFF0u};
+///   serial<uint32_t> acked = sent + 0x20u;  // 0x10, after wrapping
+///   assert(sent < acked);
+template <typename T>
+class serial {
+  assert_is_integral(T);
+  static_assert(std::is_unsigned_v<T>, "Serial numbers are unsigned.");
+
+  using Self = serial<T>;
+
+ public:
+  using value_type = T;
+
+  /// ### `kMaxIncrement`
+  ///
+  /// The largest increment that RFC 1982 defines: 2^(bits - 1) - 1.
+  static constexpr T kMaxIncrement = std::numeric_limits<T>::max() >> 1;
+
+  /// ### `serial`
+  ///
+  /// The default constructor. The contents of the object are undefined. 😕
+  /// Best practice is to use `-ftrivial-auto-var-init=zero` or to
+  /// explicitly initialize the object.
+  serial() = default;
+
+  /// ### `serial`
+  ///
+  /// Constructs and initializes.
+  template <typename U, std::enable_if_t<std::is_same_v<T, U>, int> = 0>
+  serial(U value) : value_(value) {}
+
+  /// ### `operator+=`
+  ///
+  /// Advances by `increment`, wrapping. `trap`s if `increment` is negative or
+  /// greater than `kMaxIncrement`.
+  template <typename U>
+  Self& operator+=(U increment) {
+    assert_is_integral(U);
+    if (!in_range<T>(increment) || static_cast<T>(increment) > kMaxIncrement) {
+      trap();
+    }
+    value_ += wrapping<T>{static_cast<T>(increment)};
+    return *this;
+  }
+
+  /// ### `operator+`
+  ///
+  /// Returns `lhs` advanced by `increment`, like `operator+=`.
+  template <typename U>
+  friend Self operator+(Self lhs, U increment) {
+    lhs += increment;
+    return lhs;
+  }
+
+  /// ### `operator++`
+  ///
+  /// Advances by 1, wrapping, and returns the new value.
+  Self& operator++() {
+    value_ += wrapping<T>{T{1}};
+    return *this;
+  }
+
+  /// ### `operator++`
+  ///
+  /// Advances by 1, wrapping, and returns the old value.
+  Self operator++(int) {
+    const Self previous = *this;
+    ++*this;
+    return previous;
+  }
+
+  /// ### `operator==`
+  ///
+  /// Returns true if `lhs` is equal to `rhs`.
+  friend bool operator==(Self lhs, Self rhs) {
+    return lhs.value_ == rhs.value_;
+  }
+
+  /// ### `operator!=`
+  ///
+  /// Returns true if `lhs` is not equal to `rhs`.
+  friend bool operator!=(Self lhs, Self rhs) { return !(lhs == rhs); }
+
+  /// ### `operator<`
+  ///
+  /// Returns true if `rhs` is ahead of `lhs` by less than half the range.
+  friend bool operator<(Self lhs, Self rhs) {
+    const T ahead = static_cast<T>(rhs.value_ - lhs.value_);
+    return ahead != 0 && ahead <= kMaxIncrement;
+  }
+
+  /// ### `operator>`
+  ///
+  /// Returns true if `rhs < lhs`.
+  friend bool operator>(Self lhs, Self rhs) { return rhs < lhs; }
+
+  /// ### `operator<=`
+  ///
+  /// Returns true if `lhs < rhs` or `lhs == rhs`. (This is not `!(lhs >
+  /// rhs)`, which is also true if they are half the range apart.)
+  friend bool operator<=(Self lhs, Self rhs) {
+    return lhs < rhs || lhs == rhs;
+  }
+
+  /// ### `operator>=`
+  ///
+  /// Returns true if `lhs > rhs` or `lhs == rhs`.
+  friend bool operator>=(Self lhs, Self rhs) { return rhs <= lhs; }
+
+  /// ### `operator T`
+  ///
+  /// Returns the plain `T` value. This is explicit, so that serial numbers
+  /// are not compared as plain numbers by accident.
+  explicit operator T() const { return static_cast<T>(value_); }
+
+  /// ### `operator<<`
+  ///
+  /// Writes `self`'s value to the `ostream`, and returns the `ostream`.
+  friend std::ostream& operator<<(std::ostream& os, Self self) {
+    os << self.value_;
+    return os;
+  }
+
+ private:
+  wrapping<T> value_;
+};
+
+static_assert(std::is_trivial_v<serial<uint32_t>>,
+              "`serial<T>` must be trivial");
+static_assert(sizeof(serial<uint32_t>) == sizeof(uint32_t),
+              "sizeof(serial<uint32_t>) must == sizeof(uint32_t)");
+
+/// ### `serial_distance`
+///
+/// Returns how far `to` is ahead of `from`: `to - from`, wrapped, as a signed
+/// number. It is negative if `to` is behind. (If they are exactly half the
+/// range apart, it is the minimum of the signed type.)
+template <typename T>
+std::make_signed_t<T> serial_distance(serial<T> from, serial<T> to) {
+  return static_cast<std::make_signed_t<T>>(
+      static_cast<T>(static_cast<T>(to) - static_cast<T>(from)));
+}
+
+/// ### `in_window`
+///
+/// Returns true if `value` is in the window of `width` serial numbers that
+/// starts at `low`, [`low`, `low + width`), wrapping.
+template <typename T>
+bool in_window(serial<T> value,
+               serial<T> low,
+               typename serial<T>::value_type width) {
+  return static_cast<T>(static_cast<T>(value) - static_cast<T>(low)) < width;
+}
+
+/// ### `in_window`
+///
+/// Computes `result[i] = in_window(values[i], low, width)`, and returns the
+/// number of `values` in the window. `values` must have at least as many
+/// elements as `result`; if not, this function `trap`s.
+///
+/// This is the check of a batch of acknowledgments against the send window.
+/// The loop has no branches, so compilers vectorize it; with `as_serial`,
+/// arrays of plain sequence numbers need no copy:
+///
+///   std::vector<uint32_t> acks = ...;
+///   bool valid[kBatch];
+///   const size_t count = in_window(as_serial<const uint32_t>(acks),
+///                                  snd_una, snd_wnd, valid);
+template <typename T>
+size_t in_window(span<const serial<T>> values,
+                 serial<T> low,
+                 typename serial<T>::value_type width,
+                 span<bool> result) {
+  if (values.size() < result.size()) {
+    trap();
+  }
+  const span<const T> raw = internal::span_cast<const T>(values);
+  const T start = static_cast<T>(low);
+  size_t count = 0;
+  for (size_t i = 0; i < result.size(); i++) {
+    const bool inside = static_cast<T>(raw[i] - start) < width;
+    result[i] = inside;
+    count += inside;
+  }
+  return count;
+}
+
+/// ### `as_serial`
+///
+/// Returns a view of `values` as `serial<T>`s, without copying. See
+/// `as_trapping`.
+template <typename T>
+span<internal::rewrapped_t<serial, T>> as_serial(span<T> values) {
+  return internal::span_cast<internal::rewrapped_t<serial, T>>(values);
+}
+
+/// ### `as_underlying`
+///
+/// Returns a view of `values` as plain `T`s, without copying. The inverse of
+/// `as_serial`.
+template <typename T>
+span<T> as_underlying(span<serial<T>> values) {
+  return internal::span_cast<T>(values);
+}
+
+/// ### `as_underlying`
+///
+/// Returns a view of `values` as plain `T`s, without copying. The inverse of
+/// `as_serial`.
+template <typename T>
+span<const T> as_underlying(span<const serial<T>> values) {
+  return internal::span_cast<const T>(values);
+}
+
+}  // namespace integers
+
+#endif  // SERIAL_H_
@@ -0,0 +1,163 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+#include "serial.h"
+#include "test_support.h"
+
+using namespace integers;
+using namespace std;
+
+namespace {
+
+using i8 = int8_t;
+using u8 = uint8_t;
+using i16 = int16_t;
+using u16 = uint16_t;
+using i32 = int32_t;
+using u32 = uint32_t;
+using i64 = int64_t;
+using u64 = uint64_t;
+
+// The examples of RFC 1982 section 5.2, with SERIAL_BITS = 8.
+void TestRfc1982() {
+  using S = serial<u8>;
+  EXPECT(127 == S::kMaxIncrement);
+  EXPECT(S{u8{0}} + 1 == S{u8{1}});
+  EXPECT(S{u8{255}} + 1 == S{u8{0}});
+  EXPECT(S{u8{100}} + 100 == S{u8{200}});
+  EXPECT(S{u8{200}} + 100 == S{u8{44}});
+
+  const u8 less[][2] = {{0, 1},     {0, 44},    {0, 100},  {44, 100},
+                        {100, 200}, {255, 0},   {255, 100}, {200, 0},
+                        {200, 44},  {128, 255}, {129, 0}};
+  for (const auto& pair : less) {
+    const S a{pair[0]};
+    const S b{pair[1]};
+    EXPECT(a < b && a <= b && b > a && b >= a);
+    EXPECT(!(b < a) && !(b <= a) && !(a > b) && !(a >= b));
+    EXPECT(a != b);
+  }
+
+  // Numbers half the range apart are not ordered.
+  for (u32 i = 0; i < 256; i++) {
+    const S a{static_cast<u8>(i)};
+    const S b = a + 127 + 1;
+    EXPECT(!(a < b) && !(b < a) && !(a > b) && !(a <= b) && !(a >= b));
+    EXPECT(a != b);
+    EXPECT(a <= a && a >= a && !(a < a) && !(a > a));
+  }
+
+  S x{u8{0}};
+  EXPECT_DEATH(x += 128);
+  EXPECT_DEATH(x += -1);
+  EXPECT_DEATH(x + 300);
+  x += 127;
+  EXPECT(127 == static_cast<u8>(x));
+}
+
+template <typename T>
+void GenericTestSerial() {
+  using S = serial<T>;
+  using Signed = make_signed_t<T>;
+  constexpr T max = numeric_limits<T>::max();
+  constexpr T half = S::kMaxIncrement;
+
+  S x{max};
+  EXPECT(max == static_cast<T>(x++));
+  EXPECT(T{0} == static_cast<T>(x));
+  EXPECT(T{1} == static_cast<T>(++x));
+  EXPECT(S{max} < x);
+
+  EXPECT(2 == serial_distance(S{max}, x));
+  EXPECT(-2 == serial_distance(x, S{max}));
+  EXPECT(static_cast<Signed>(half) == serial_distance(x, x + half));
+  EXPECT(numeric_limits<Signed>::min() ==
+         serial_distance(x, x + half + T{1}));
+
+  // Windows that wrap around.
+  const S low{static_cast<T>(max - 9)};
+  EXPECT(in_window(low, low, T{20}));
+  EXPECT(in_window(S{max}, low, T{20}));
+  EXPECT(in_window(S{T{9}}, low, T{20}));
+  EXPECT(!in_window(S{T{10}}, low, T{20}));
+  EXPECT(!in_window(S{static_cast<T>(max - 10)}, low, T{20}));
+  EXPECT(!in_window(low, low, T{0}));
+  EXPECT(in_window(S{static_cast<T>(max - 11)}, low, max));
+  EXPECT(!in_window(S{static_cast<T>(max - 10)}, low, max));
+
+  // The batch version agrees with the scalar one.
+  vector<T> values(300);
+  for (size_t i = 0; i < values.size(); i++) {
+    values[i] = static_cast<T>(max - 150 + i * 7);
+  }
+  const span<const S> serials = as_serial<const T>(values);
+  bool inside[300];
+  const T width = 400 % (T{max} / 2);
+  const size_t count = in_window(serials, low, width, inside);
+  size_t expected = 0;
+  for (size_t i = 0; i < values.size(); i++) {
+    EXPECT(in_window(serials[i], low, width) == inside[i]);
+    expected += inside[i];
+  }
+  EXPECT(expected == count);
+  EXPECT(0 < count && count < values.size());
+  EXPECT_DEATH(
+      in_window(serials.first(10), low, width, span<bool>(inside, 11)));
+}
+
+template <class... T>
+void CallGenericTestSerial() {
+  (GenericTestSerial<T>(), ...);
+}
+
+void TestSerial() {
+  CallGenericTestSerial<u8, u16, u32, u64>();
+
+  // TCP sequence numbers across the wrap.
+  serial<u32> sent{0xFFFFFFF0u};
+  const serial<u32> acked = sent + 0x20u;
+  EXPECT(sent < acked);
+  EXPECT(0x10u == static_cast<u32>(acked));
+  EXPECT(0x20 == serial_distance(sent, acked));
+  sent += 0x7FFFFFFFu;
+  EXPECT(acked < sent);
+
+  ostringstream out;
+  out << acked;
+  EXPECT("16" == out.str());
+}
+
+void TestViews() {
+  vector<u32> column = {1, 2, 3};
+  const span<serial<u32>> view = as_serial<u32>(column);
+  EXPECT(static_cast<const void*>(column.data()) == view.data());
+  for (serial<u32>& x : view) {
+    ++x;
+  }
+  EXPECT((vector<u32>{2, 3, 4}) == column);
+  EXPECT(column.data() == as_underlying(view).data());
+}
+
+}  // namespace
+
+int main() {
+  TestRfc1982();
+  TestSerial();
+  TestViews();
+}
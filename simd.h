@@ -0,0 +1,479 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SIMD_H_
+#define SIMD_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <limits>
+#include <type_traits>
+
+#include "is_integral.h"
+#include "overflow_status.h"
+#include "trap.h"
+#include "trapping.h"
+
+#if !__has_builtin(__builtin_convertvector)
+#error simd.h needs the vector extensions of GCC or Clang.
+#endif
+
+namespace internal {
+
+enum class simd_policy { trapping, wrapping, clamping };
+
+// The vector extension types of `N` lanes of `T`, and of the same size of
+// signed and unsigned lanes. (`reinterpret_cast` converts between vector
+// types of the same size.)
+template <typename T, size_t N>
+struct simd_types {
+  typedef T vector __attribute__((vector_size(N * sizeof(T))));
+  typedef std::make_signed_t<T> mask
+      __attribute__((vector_size(N * sizeof(T))));
+  typedef std::make_unsigned_t<T> bits
+      __attribute__((vector_size(N * sizeof(T))));
+};
+
+// Returns true if any lane of `mask` is set, by ORing its halves together
+// down to a 64-bit word. (Compilers do not turn a loop over the lanes into
+// that.)
+template <typename Mask>
+bool simd_any(Mask mask) {
+  if constexpr (sizeof(Mask) > sizeof(uint64_t)) {
+    typedef std::remove_reference_t<decltype(mask[0])> Half
+        __attribute__((vector_size(sizeof(Mask) / 2)));
+    Half low;
+    Half high;
+    memcpy(&low, &mask, sizeof(low));
+    memcpy(&high, reinterpret_cast<const char*>(&mask) + sizeof(low),
+           sizeof(high));
+    return simd_any(low | high);
+  } else {
+    uint64_t word;
+    memcpy(&word, &mask, sizeof(word));
+    return word != 0;
+  }
+}
+
+// Returns `x` where `mask` is set, and `y` elsewhere.
+template <typename Vector, typename Mask>
+Vector simd_select(Mask mask, Vector x, Vector y) {
+  return reinterpret_cast<Vector>((reinterpret_cast<Mask>(x) & mask) |
+                               (reinterpret_cast<Mask>(y) & ~mask));
+}
+
+template <typename T, size_t N>
+typename simd_types<T, N>::vector simd_broadcast(T x) {
+  typename simd_types<T, N>::vector v;
+  for (size_t i = 0; i < N; i++) {
+    v[i] = x;
+  }
+  return v;
+}
+
+// These compute `x + y`, `x - y`, and `x * y` lane by lane, wrapping, and set
+// `*overflow` in the lanes that overflowed. The additions and subtractions
+// are of unsigned lanes, so they wrap rather than being undefined, and the
+// signed overflow tests are those of `vector_add_overflow` and so on in
+// trapping.h.
+template <typename T, size_t N>
+typename simd_types<T, N>::vector simd_add(
+    typename simd_types<T, N>::vector x,
+    typename simd_types<T, N>::vector y,
+    typename simd_types<T, N>::mask* overflow) {
+  using Types = simd_types<T, N>;
+  using Bits = typename Types::bits;
+  using Mask = typename Types::mask;
+  const Bits r = reinterpret_cast<Bits>(x) + reinterpret_cast<Bits>(y);
+  if constexpr (std::is_signed_v<T>) {
+    *overflow = reinterpret_cast<Mask>((reinterpret_cast<Bits>(x) ^ r) &
+                                       (reinterpret_cast<Bits>(y) ^ r)) < 0;
+  } else {
+    *overflow = r < x;
+  }
+  return reinterpret_cast<typename Types::vector>(r);
+}
+
+template <typename T, size_t N>
+typename simd_types<T, N>::vector simd_sub(
+    typename simd_types<T, N>::vector x,
+    typename simd_types<T, N>::vector y,
+    typename simd_types<T, N>::mask* overflow) {
+  using Types = simd_types<T, N>;
+  using Bits = typename Types::bits;
+  using Mask = typename Types::mask;
+  const Bits r = reinterpret_cast<Bits>(x) - reinterpret_cast<Bits>(y);
+  if constexpr (std::is_signed_v<T>) {
+    const Bits bits_x = reinterpret_cast<Bits>(x);
+    *overflow = reinterpret_cast<Mask>((bits_x ^ reinterpret_cast<Bits>(y)) &
+                                       (bits_x ^ r)) < 0;
+  } else {
+    *overflow = x < y;
+  }
+  return reinterpret_cast<typename Types::vector>(r);
+}
+
+// Lanes of up to 32 bits multiply exactly in lanes twice as wide, and narrow
+// back. There are no vectors of 128-bit lanes, so 64-bit lanes multiply one
+// at a time.
+template <typename T, size_t N>
+typename simd_types<T, N>::vector simd_mul(
+    typename simd_types<T, N>::vector x,
+    typename simd_types<T, N>::vector y,
+    typename simd_types<T, N>::mask* overflow) {
+  using Types = simd_types<T, N>;
+  using Vector = typename Types::vector;
+  using Mask = typename Types::mask;
+  if constexpr (sizeof(T) <= 4) {
+    using Wide = std::conditional_t<
+        std::is_signed_v<T>,
+        std::conditional_t<sizeof(T) == 1, int16_t,
+                           std::conditional_t<sizeof(T) == 2, int32_t,
+                                              int64_t>>,
+        std::conditional_t<sizeof(T) == 1, uint16_t,
+                           std::conditional_t<sizeof(T) == 2, uint32_t,
+                                              uint64_t>>>;
+    using WideTypes = simd_types<Wide, N>;
+    using WideVector = typename WideTypes::vector;
+    using WideBits = typename WideTypes::bits;
+    // The product of two `T`s fits in `Wide`, but multiplying the unsigned
+    // bits keeps the compiler from assuming that it cannot overflow.
+    const WideBits p =
+        reinterpret_cast<WideBits>(__builtin_convertvector(x, WideVector)) *
+        reinterpret_cast<WideBits>(__builtin_convertvector(y, WideVector));
+    const Vector r = reinterpret_cast<Vector>(
+        __builtin_convertvector(p, typename Types::bits));
+    const typename WideTypes::mask wide_overflow =
+        __builtin_convertvector(r, WideVector) !=
+        reinterpret_cast<WideVector>(p);
+    *overflow = __builtin_convertvector(wide_overflow, Mask);
+    return r;
+  } else {
+    Vector r;
+    for (size_t i = 0; i < N; i++) {
+      T lane;
+      (*overflow)[i] = integers::mul_overflow(x[i], y[i], &lane) ? -1 : 0;
+      r[i] = lane;
+    }
+    return r;
+  }
+}
+
+// Returns `max` in the lanes where `positive` is set, and `min` elsewhere.
+template <typename T, size_t N>
+typename simd_types<T, N>::vector simd_limit(
+    typename simd_types<T, N>::mask positive) {
+  return simd_select(positive,
+                     simd_broadcast<T, N>(std::numeric_limits<T>::max()),
+                     simd_broadcast<T, N>(std::numeric_limits<T>::min()));
+}
+
+}  // namespace internal
+
+namespace integers {
+
+/// ## `trapping_simd<T, N>`, `wrapping_simd<T, N>`, and `clamping_simd<T, N>`
+///
+/// These template classes are vectors of `N` lanes of `T`, which live in
+/// vector registers and which you can use to write your own kernels (beyond
+/// the span functions in batch.h) with the semantics of `trapping<T>`,
+/// `wrapping<T>`, or `clamping<T>` in every lane:
+///
+///   using Vector = trapping_simd<int32_t, 8>;
+///   for (size_t i = 0; i + Vector::size() <= count; i += Vector::size()) {
+///     (Vector::load(&a[i]) * Vector::load(&b[i]) + Vector::load(&c[i]))
+///         .store(&out[i]);
+///   }
+///
+/// An operation on a `trapping_simd` computes all its lanes, and then tests
+/// once whether any overflowed, and `trap`s if so (or, if
+/// `INTEGERS_STICKY_OVERFLOW` is defined, records the overflow and returns the
+/// wrapped lanes).
+///
+/// `N * sizeof(T)` must be 8, 16, 32, or 64 bytes. For speed, make it the size
+/// of the target’s vector registers (16 bytes for SSE2 and NEON, 32 for
+/// AVX2): compilers split bigger vectors into several registers. (Compilers
+/// may also warn that passing vectors bigger than the target’s registers
+/// changes the ABI.)
+///
+/// They support addition, subtraction, and multiplication. Multiplication of
+/// 64-bit lanes is a lane at a time, as there are no 128-bit lanes in which
+/// the products would be exact.
+///
+/// These classes build on the vector extensions of GCC and Clang.
+template <typename T, size_t N, internal::simd_policy Policy>
+class basic_simd {
+  assert_is_integral(T);
+  static_assert(N * sizeof(T) == 8 || N * sizeof(T) == 16 ||
+                    N * sizeof(T) == 32 || N * sizeof(T) == 64,
+                "N * sizeof(T) must be 8, 16, 32, or 64");
+
+  using Self = basic_simd<T, N, Policy>;
+  using Types = internal::simd_types<T, N>;
+  using Vector = typename Types::vector;
+  using Mask = typename Types::mask;
+
+ public:
+  using value_type = T;
+
+  /// ### `size`
+  ///
+  /// Returns the number of lanes, `N`.
+  static constexpr size_t size() { return N; }
+
+  /// ### `basic_simd`
+  ///
+  /// Constructs a vector with every lane 0.
+  basic_simd() : lanes_() {}
+
+  /// ### `basic_simd`
+  ///
+  /// Constructs a vector with every lane `value`.
+  explicit basic_simd(T value)
+      : lanes_(internal::simd_broadcast<T, N>(value)) {}
+
+  /// ### `load`
+  ///
+  /// Loads `N` values from `data`, which need not be aligned, and returns
+  /// them as a vector.
+  static Self load(const T* data) {
+    Self result;
+    memcpy(&result.lanes_, data, sizeof(result.lanes_));
+    return result;
+  }
+
+  /// ### `store`
+  ///
+  /// Stores the `N` lanes to `data`, which need not be aligned.
+  void store(T* data) const { memcpy(data, &lanes_, sizeof(lanes_)); }
+
+  /// ### `operator[]`
+  ///
+  /// Returns the value of lane `lane`, which must be less than `N`.
+  T operator[](size_t lane) const { return lanes_[lane]; }
+
+  /// ### `operator+=`
+  ///
+  /// Adds `other` lane by lane, under the vector’s policy, and returns
+  /// `*this`.
+  Self& operator+=(Self other) {
+    *this = *this + other;
+    return *this;
+  }
+
+  /// ### `operator+=`
+  ///
+  /// Adds `other` to every lane, under the vector’s policy, and returns
+  /// `*this`.
+  Self& operator+=(T other) { return *this += Self(other); }
+
+  /// ### `operator+`
+  ///
+  /// Returns the lane-by-lane sums of `lhs` and `rhs`. Overflowing lanes
+  /// `trap`, wrap, or clamp, according to the vector’s policy.
+  friend Self operator+(Self lhs, Self rhs) {
+    Mask overflow;
+    Self result =
+        FromLanes(internal::simd_add<T, N>(lhs.lanes_, rhs.lanes_, &overflow));
+    if constexpr (Policy == internal::simd_policy::clamping) {
+      if constexpr (std::is_signed_v<T>) {
+        result.Clamp(overflow,
+                     internal::simd_limit<T, N>(rhs.lanes_ >= Vector{}));
+      } else {
+        result.Clamp(overflow, ~Vector{});
+      }
+    }
+    result.Check(overflow, overflow_flags::add);
+    return result;
+  }
+
+  /// ### `operator+`
+  ///
+  /// Returns the sums of each lane of `lhs` and `rhs`, like `lhs + Self(rhs)`.
+  friend Self operator+(Self lhs, T rhs) { return lhs + Self(rhs); }
+
+  /// ### `operator+`
+  ///
+  /// Returns the sums of `lhs` and each lane of `rhs`, like `Self(lhs) + rhs`.
+  friend Self operator+(T lhs, Self rhs) { return Self(lhs) + rhs; }
+
+  /// ### `operator-=`
+  ///
+  /// Subtracts `other` lane by lane, under the vector’s policy, and returns
+  /// `*this`.
+  Self& operator-=(Self other) {
+    *this = *this - other;
+    return *this;
+  }
+
+  /// ### `operator-=`
+  ///
+  /// Subtracts `other` from every lane, under the vector’s policy, and
+  /// returns `*this`.
+  Self& operator-=(T other) { return *this -= Self(other); }
+
+  /// ### `operator-`
+  ///
+  /// Returns the lane-by-lane differences of `lhs` and `rhs`. Overflowing
+  /// lanes `trap`, wrap, or clamp, according to the vector’s policy.
+  friend Self operator-(Self lhs, Self rhs) {
+    Mask overflow;
+    Self result =
+        FromLanes(internal::simd_sub<T, N>(lhs.lanes_, rhs.lanes_, &overflow));
+    if constexpr (Policy == internal::simd_policy::clamping) {
+      if constexpr (std::is_signed_v<T>) {
+        result.Clamp(overflow,
+                     internal::simd_limit<T, N>(rhs.lanes_ < Vector{}));
+      } else {
+        result.Clamp(overflow, Vector{});
+      }
+    }
+    result.Check(overflow, overflow_flags::sub);
+    return result;
+  }
+
+  /// ### `operator-`
+  ///
+  /// Returns the differences of each lane of `lhs` and `rhs`, like
+  /// `lhs - Self(rhs)`.
+  friend Self operator-(Self lhs, T rhs) { return lhs - Self(rhs); }
+
+  /// ### `operator-`
+  ///
+  /// Returns the differences of `lhs` and each lane of `rhs`, like
+  /// `Self(lhs) - rhs`.
+  friend Self operator-(T lhs, Self rhs) { return Self(lhs) - rhs; }
+
+  /// ### `operator*=`
+  ///
+  /// Multiplies by `other` lane by lane, under the vector’s policy, and
+  /// returns `*this`.
+  Self& operator*=(Self other) {
+    *this = *this * other;
+    return *this;
+  }
+
+  /// ### `operator*=`
+  ///
+  /// Multiplies every lane by `other`, under the vector’s policy, and returns
+  /// `*this`.
+  Self& operator*=(T other) { return *this *= Self(other); }
+
+  /// ### `operator*`
+  ///
+  /// Returns the lane-by-lane products of `lhs` and `rhs`. Overflowing lanes
+  /// `trap`, wrap, or clamp, according to the vector’s policy.
+  friend Self operator*(Self lhs, Self rhs) {
+    Mask overflow;
+    Self result =
+        FromLanes(internal::simd_mul<T, N>(lhs.lanes_, rhs.lanes_, &overflow));
+    if constexpr (Policy == internal::simd_policy::clamping) {
+      if constexpr (std::is_signed_v<T>) {
+        result.Clamp(overflow, internal::simd_limit<T, N>(
+                                   (lhs.lanes_ ^ rhs.lanes_) >= Vector{}));
+      } else {
+        result.Clamp(overflow, ~Vector{});
+      }
+    }
+    result.Check(overflow, overflow_flags::mul);
+    return result;
+  }
+
+  /// ### `operator*`
+  ///
+  /// Returns the products of each lane of `lhs` and `rhs`, like
+  /// `lhs * Self(rhs)`.
+  friend Self operator*(Self lhs, T rhs) { return lhs * Self(rhs); }
+
+  /// ### `operator*`
+  ///
+  /// Returns the products of `lhs` and each lane of `rhs`, like
+  /// `Self(lhs) * rhs`.
+  friend Self operator*(T lhs, Self rhs) { return Self(lhs) * rhs; }
+
+  /// ### `operator==`
+  ///
+  /// Returns true if every lane of `lhs` is equal to the same lane of `rhs`.
+  friend bool operator==(Self lhs, Self rhs) {
+    return !internal::simd_any(lhs.lanes_ != rhs.lanes_);
+  }
+
+  /// ### `operator!=`
+  ///
+  /// Returns true if any lane of `lhs` is not equal to the same lane of `rhs`.
+  friend bool operator!=(Self lhs, Self rhs) { return !(lhs == rhs); }
+
+ private:
+  static Self FromLanes(Vector lanes) {
+    Self result;
+    result.lanes_ = lanes;
+    return result;
+  }
+
+  // Replaces the lanes that overflowed with `limit`.
+  void Clamp(Mask overflow, Vector limit) {
+    lanes_ = internal::simd_select(overflow, limit, lanes_);
+  }
+
+  // Traps (or records `flag`) if any lane overflowed, given the trapping
+  // policy.
+  void Check(Mask overflow, overflow_flags flag) const {
+    if constexpr (Policy == internal::simd_policy::trapping) {
+      const bool any = internal::simd_any(overflow);
+#if defined(INTEGERS_STICKY_OVERFLOW)
+      record_overflow(any, flag);
+#else
+      static_cast<void>(flag);
+      if (any) {
+        trap();
+      }
+#endif
+    } else {
+      static_cast<void>(overflow);
+      static_cast<void>(flag);
+    }
+  }
+
+  Vector lanes_;
+};
+
+/// ### `trapping_simd`
+///
+/// Vectors whose operations `trap` if any lane overflows.
+template <typename T, size_t N>
+using trapping_simd = basic_simd<T, N, internal::simd_policy::trapping>;
+
+/// ### `wrapping_simd`
+///
+/// Vectors whose lanes wrap around on overflow.
+template <typename T, size_t N>
+using wrapping_simd = basic_simd<T, N, internal::simd_policy::wrapping>;
+
+/// ### `clamping_simd`
+///
+/// Vectors whose overflowing lanes become `T`’s minimum or maximum, whichever
+/// is nearest.
+template <typename T, size_t N>
+using clamping_simd = basic_simd<T, N, internal::simd_policy::clamping>;
+
+static_assert(sizeof(trapping_simd<int32_t, 4>) == 16,
+              "sizeof(trapping_simd<int32_t, 4>) must == 16");
+static_assert(sizeof(clamping_simd<uint8_t, 32>) == 32,
+              "sizeof(clamping_simd<uint8_t, 32>) must == 32");
+
+}  // namespace integers
+
+#endif  // SIMD_H_
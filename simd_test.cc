@@ -0,0 +1,164 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <limits>
+
+#include "clamping.h"
+#include "simd.h"
+#include "test_support.h"
+#include "trapping.h"
+
+using namespace integers;
+using namespace std;
+
+namespace {
+
+using i8 = int8_t;
+using u8 = uint8_t;
+using i16 = int16_t;
+using u16 = uint16_t;
+using i32 = int32_t;
+using u32 = uint32_t;
+using i64 = int64_t;
+using u64 = uint64_t;
+
+enum class Op { add, sub, mul };
+
+// Checks every lane of `x op y`, for each policy, against the scalar
+// functions.
+template <typename T, size_t N>
+void TestLanes(const T (&x)[N], const T (&y)[N], Op op) {
+  const auto apply = [op](auto a, auto b) {
+    switch (op) {
+      case Op::add:
+        return a + b;
+      case Op::sub:
+        return a - b;
+      default:
+        return a * b;
+    }
+  };
+
+  const auto wrapped = apply(wrapping_simd<T, N>::load(x),
+                             wrapping_simd<T, N>::load(y));
+  const auto clamped = apply(clamping_simd<T, N>::load(x),
+                             clamping_simd<T, N>::load(y));
+  bool overflow = false;
+  T expected[N];
+  for (size_t i = 0; i < N; i++) {
+    const u64 a = static_cast<u64>(x[i]);
+    const u64 b = static_cast<u64>(y[i]);
+    switch (op) {
+      case Op::add:
+        overflow |= add_overflow(x[i], y[i], &expected[i]);
+        EXPECT(static_cast<T>(a + b) == wrapped[i]);
+        EXPECT((clamping_add<T, T, T>(x[i], y[i])) == clamped[i]);
+        break;
+      case Op::sub:
+        overflow |= sub_overflow(x[i], y[i], &expected[i]);
+        EXPECT(static_cast<T>(a - b) == wrapped[i]);
+        EXPECT((clamping_sub<T, T, T>(x[i], y[i])) == clamped[i]);
+        break;
+      default:
+        overflow |= mul_overflow(x[i], y[i], &expected[i]);
+        EXPECT(static_cast<T>(a * b) == wrapped[i]);
+        EXPECT((clamping_mul<T, T, T>(x[i], y[i])) == clamped[i]);
+    }
+  }
+
+  if (overflow) {
+    EXPECT_DEATH(static_cast<void>(apply(trapping_simd<T, N>::load(x),
+                                         trapping_simd<T, N>::load(y))));
+  } else {
+    EXPECT((trapping_simd<T, N>::load(expected) ==
+            apply(trapping_simd<T, N>::load(x), trapping_simd<T, N>::load(y))));
+  }
+}
+
+template <typename T, size_t N>
+void GenericTestSimd() {
+  constexpr T max = numeric_limits<T>::max();
+  constexpr T min = numeric_limits<T>::min();
+  const T values[] = {
+      min, static_cast<T>(min + 1), static_cast<T>(-1), 0, 1, 2, 3,
+      static_cast<T>(max / 2), static_cast<T>(max - 1), max};
+  constexpr size_t kValues = sizeof(values) / sizeof(values[0]);
+
+  // Every pair of values, in various lanes.
+  for (size_t i = 0; i < kValues; i++) {
+    for (size_t j = 0; j < kValues; j++) {
+      T x[N];
+      T y[N];
+      for (size_t lane = 0; lane < N; lane++) {
+        x[lane] = values[(i + lane) % kValues];
+        y[lane] = values[(j + lane * 3) % kValues];
+      }
+      TestLanes(x, y, Op::add);
+      TestLanes(x, y, Op::sub);
+      TestLanes(x, y, Op::mul);
+    }
+  }
+
+  // Vectors in range.
+  T small[N];
+  for (size_t lane = 0; lane < N; lane++) {
+    small[lane] = static_cast<T>(lane % 8);
+  }
+  TestLanes(small, small, Op::add);
+  TestLanes(small, small, Op::sub);
+  TestLanes(small, small, Op::mul);
+}
+
+template <typename... T>
+void CallGenericTestSimd() {
+  (GenericTestSimd<T, 8 / sizeof(T)>(), ...);
+  (GenericTestSimd<T, 16 / sizeof(T)>(), ...);
+}
+
+void TestSimd() {
+  CallGenericTestSimd<i8, u8, i16, u16, i32, u32, i64, u64>();
+}
+
+void TestValue() {
+  using Vector = trapping_simd<i32, 4>;
+  EXPECT(4 == Vector::size());
+  EXPECT(Vector(0) == Vector());
+  EXPECT(Vector(1) != Vector());
+
+  const i32 a[] = {1, 2, 3, 4};
+  i32 out[4];
+  Vector v = Vector::load(a);
+  v += 1;
+  v *= 2;
+  v -= Vector(1);
+  v.store(out);
+  EXPECT(3 == out[0]);
+  EXPECT(9 == out[3]);
+  EXPECT(9 == (2 * Vector::load(a) + 1)[3]);
+  EXPECT(-3 == (0 - Vector::load(a))[2]);
+
+  EXPECT_DEATH(static_cast<void>(Vector::load(a) * numeric_limits<i32>::max()));
+  EXPECT(numeric_limits<i32>::max() ==
+         (clamping_simd<i32, 4>::load(a) * numeric_limits<i32>::max())[3]);
+  EXPECT(numeric_limits<i32>::min() + 3 ==
+         (wrapping_simd<i32, 4>::load(a) + numeric_limits<i32>::max())[3]);
+}
+
+}  // namespace
+
+int main() {
+  TestSimd();
+  TestValue();
+}
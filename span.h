@@ -0,0 +1,147 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SPAN_H_
+#define SPAN_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<span>)
+#include <span>
+#endif
+
+namespace integers {
+
+#ifdef __cpp_lib_span
+using std::span;
+#else
+// Polyfill of (the dynamic-extent subset of) C++20 `std::span` to C++17.
+template <typename T>
+class span {
+ public:
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+  using iterator = T*;
+
+  constexpr span() noexcept : data_(nullptr), size_(0) {}
+
+  constexpr span(T* data, size_t size) noexcept : data_(data), size_(size) {}
+
+  template <size_t N>
+  constexpr span(T (&array)[N]) noexcept : data_(array), size_(N) {}
+
+  // Constructs from any contiguous container, such as `std::vector` or
+  // `std::array`, whose elements convert to `T` by qualification.
+  template <typename Container,
+            typename = std::enable_if_t<
+                !std::is_same_v<std::remove_cv_t<Container>, span> &&
+                std::is_convertible_v<
+                    std::remove_pointer_t<decltype(std::declval<Container&>()
+                                                       .data())> (*)[],
+                    T (*)[]>>>
+  constexpr span(Container& container) noexcept
+      : data_(container.data()), size_(container.size()) {}
+
+  // Like `std::span`, a span of `const` elements can also view a temporary.
+  template <typename Container,
+            typename = std::enable_if_t<
+                std::is_const_v<T> &&
+                !std::is_same_v<std::remove_cv_t<Container>, span> &&
+                std::is_convertible_v<
+                    std::remove_pointer_t<decltype(std::declval<
+                                                       const Container&>()
+                                                       .data())> (*)[],
+                    T (*)[]>>>
+  constexpr span(const Container& container) noexcept
+      : data_(container.data()), size_(container.size()) {}
+
+  template <typename U,
+            typename =
+                std::enable_if_t<std::is_convertible_v<U (*)[], T (*)[]>>>
+  constexpr span(const span<U>& other) noexcept
+      : data_(other.data()), size_(other.size()) {}
+
+  constexpr T* data() const noexcept { return data_; }
+  constexpr size_t size() const noexcept { return size_; }
+  constexpr size_t size_bytes() const noexcept { return size_ * sizeof(T); }
+  constexpr bool empty() const noexcept { return size_ == 0; }
+
+  constexpr T& operator[](size_t i) const { return data_[i]; }
+
+  constexpr iterator begin() const noexcept { return data_; }
+  constexpr iterator end() const noexcept { return data_ + size_; }
+
+  constexpr span first(size_t count) const { return span(data_, count); }
+
+  constexpr span last(size_t count) const {
+    return span(data_ + (size_ - count), count);
+  }
+
+  constexpr span subspan(size_t offset) const {
+    return span(data_ + offset, size_ - offset);
+  }
+
+  constexpr span subspan(size_t offset, size_t count) const {
+    return span(data_ + offset, count);
+  }
+
+ private:
+  T* data_;
+  size_t size_;
+};
+#endif
+
+}  // namespace integers
+
+namespace internal {
+
+// `W<T>`, or `const W<T>` if `T` is `const`, so that a view of `T`s as `W`s
+// keeps their constness.
+template <template <typename> class W, typename T>
+using rewrapped_t = std::conditional_t<std::is_const_v<T>,
+                                       const W<std::remove_const_t<T>>,
+                                       W<std::remove_const_t<T>>>;
+
+// Returns a span of `U` that views the same memory as `values`, without
+// copying. `U` must be a trivially copyable wrapper with the layout of `T`,
+// such as `trapping<T>` or `ranged<T, Min, Max>`, so that each `T` object can
+// be reused as a `U` object. Where C++23 `std::start_lifetime_as_array` is
+// available, the `U` objects formally begin their lifetimes there; before
+// C++23, this is the plain `reinterpret_cast` that compilers support in
+// practice for such types.
+template <typename U, typename T>
+integers::span<U> span_cast(integers::span<T> values) {
+  static_assert(sizeof(U) == sizeof(T) && alignof(U) == alignof(T),
+                "U must have the layout of T.");
+  static_assert(std::is_trivially_copyable_v<U> &&
+                    std::is_standard_layout_v<U>,
+                "U must be trivially copyable and standard-layout.");
+  static_assert(std::is_const_v<U> || !std::is_const_v<T>,
+                "span_cast must not cast away const.");
+#ifdef __cpp_lib_start_lifetime_as
+  return {std::start_lifetime_as_array<std::remove_const_t<U>>(values.data(),
+                                                               values.size()),
+          values.size()};
+#else
+  return {reinterpret_cast<U*>(values.data()), values.size()};
+#endif
+}
+
+}  // namespace internal
+
+#endif  // SPAN_H_
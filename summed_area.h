@@ -0,0 +1,150 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SUMMED_AREA_H_
+#define SUMMED_AREA_H_
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+#include "batch.h"
+#include "is_integral.h"
+#include "overflow_status.h"
+#include "span.h"
+#include "trap.h"
+#include "trapping.h"
+
+namespace internal {
+
+// Computes the summed-area table of `image` into `table`, without checks. The
+// additions wrap (so that in sticky mode, an overflowing table is merely
+// wrong), but they are of unsigned integers, so they are not undefined.
+//
+// Each entry is the running total of its row plus the entry above it. The
+// running total is a chain of dependent additions, about a cycle each, and
+// the rest of the loop fits around it.
+template <typename R, typename T>
+void unchecked_summed_area_table(const T* image,
+                                 size_t width,
+                                 size_t height,
+                                 R* table) {
+  using U = std::make_unsigned_t<R>;
+  if (height == 0) {
+    return;
+  }
+  U row = 0;
+  for (size_t x = 0; x < width; x++) {
+    row += static_cast<U>(image[x]);
+    table[x] = static_cast<R>(row);
+  }
+  for (size_t y = 1; y < height; y++) {
+    const R* above = table + (y - 1) * width;
+    const T* pixels = image + y * width;
+    R* entries = table + y * width;
+    row = 0;
+    for (size_t x = 0; x < width; x++) {
+      row += static_cast<U>(pixels[x]);
+      entries[x] = static_cast<R>(row + static_cast<U>(above[x]));
+    }
+  }
+}
+
+}  // namespace internal
+
+namespace integers {
+
+/// ## Summed-Area Tables
+///
+/// The summed-area table (or integral image) of an image has, at each pixel,
+/// the sum of the pixels above and to the left of it, inclusive. A table of
+/// `width` × `height` pixels can have entries as big as `width * height` times
+/// the biggest pixel, which overflows `uint32_t` for large frames of `uint8_t`
+/// pixels. Rather than check every addition, or always use `uint64_t`, which
+/// doubles the memory traffic, check once that `R` is wide enough:
+///
+///   if (summed_area_fits<uint32_t, uint8_t>(width, height)) {
+///     std::vector<uint32_t> table(width * height);
+///     summed_area_table<uint32_t, uint8_t>(frame, width, height, table);
+///     ...
+///   } else {
+///     std::vector<uint64_t> table(width * height);
+///     summed_area_table<uint64_t, uint8_t>(frame, width, height, table);
+///     ...
+///   }
+///
+/// ### `summed_area_fits`
+///
+/// Returns true if `R` can represent every entry of the summed-area table of
+/// any `width` × `height` image whose pixels are in `[lowest, highest]`.
+template <typename R, typename T>
+bool summed_area_fits(size_t width,
+                      size_t height,
+                      T lowest = std::numeric_limits<T>::min(),
+                      T highest = std::numeric_limits<T>::max()) {
+  assert_is_integral(R);
+  assert_is_integral(T);
+
+  // Every entry is the sum of at most `width * height` pixels, so it is in
+  // `[pixels * min(lowest, 0), pixels * max(highest, 0)]`.
+  size_t pixels;
+  R bound;
+  return !mul_overflow(width, height, &pixels) &&
+         !mul_overflow(pixels, std::min(lowest, T{0}), &bound) &&
+         !mul_overflow(pixels, std::max(highest, T{0}), &bound);
+}
+
+/// ### `summed_area_table`
+///
+/// Computes the summed-area table of `image`, which is `height` rows of
+/// `width` pixels, into `table`, which must be the same size. (If not, this
+/// function `trap`s.)
+///
+/// If `summed_area_fits<R, T>(width, height)`, the computation is unchecked.
+/// Otherwise, this function first finds the image’s lowest and highest
+/// pixels, and `trap`s (or, in sticky mode, records `overflow_flags::add`) if
+/// `R` is not wide enough for those.
+template <typename R, typename T>
+void summed_area_table(span<const T> image,
+                       size_t width,
+                       size_t height,
+                       span<R> table) {
+  assert_is_integral(R);
+  assert_is_integral(T);
+  size_t pixels;
+  if (mul_overflow(width, height, &pixels) || image.size() != pixels ||
+      table.size() != pixels) {
+    trap();
+  }
+
+  if (!summed_area_fits<R, T>(width, height) && !image.empty()) {
+    const auto [lowest, highest] = internal::batch_min_max(image);
+    const bool overflow = !summed_area_fits<R>(width, height, lowest, highest);
+#if defined(INTEGERS_STICKY_OVERFLOW)
+    record_overflow(overflow, overflow_flags::add);
+#else
+    if (overflow) {
+      trap();
+    }
+#endif
+  }
+  internal::unchecked_summed_area_table(image.data(), width, height,
+                                        table.data());
+}
+
+}  // namespace integers
+
+#endif  // SUMMED_AREA_H_
@@ -0,0 +1,125 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "summed_area.h"
+#include "test_support.h"
+
+using namespace integers;
+using namespace std;
+
+namespace {
+
+using i8 = int8_t;
+using u8 = uint8_t;
+using i16 = int16_t;
+using u16 = uint16_t;
+using i32 = int32_t;
+using u32 = uint32_t;
+using i64 = int64_t;
+using u64 = uint64_t;
+
+void TestFits() {
+  // 4K frames of `uint8_t` fit in `uint32_t`; 8K frames do not.
+  EXPECT((summed_area_fits<u32, u8>(3840, 2160)));
+  EXPECT(!(summed_area_fits<u32, u8>(7680, 4320)));
+  EXPECT((summed_area_fits<u64, u8>(7680, 4320)));
+  EXPECT((summed_area_fits<u32, u16>(7680, 4320, 0, 127)));
+  EXPECT((summed_area_fits<i32, u8>(3840, 2160)));
+  EXPECT(!(summed_area_fits<i32, u8>(4096, 2160)));
+
+  EXPECT((summed_area_fits<u16, u8>(16, 16)));
+  EXPECT(!(summed_area_fits<u16, u8>(17, 16)));
+  EXPECT((summed_area_fits<i16, i8>(16, 16)));
+  EXPECT(!(summed_area_fits<u16, i8>(1, 1)));
+  EXPECT((summed_area_fits<u16, i8>(1, 1, 0, 127)));
+  EXPECT(!(summed_area_fits<i16, i8>(16, 17, -128, 0)));
+  EXPECT((summed_area_fits<i16, i8>(16, 17, -1, 100)));
+
+  EXPECT((summed_area_fits<u8, u8>(0, 1000000)));
+  EXPECT(!(summed_area_fits<u64, u8>(size_t{1} << 40, size_t{1} << 40)));
+}
+
+template <typename R, typename T>
+void TestTablePair(size_t width, size_t height, const vector<T>& image) {
+  vector<R> table(width * height);
+  summed_area_table<R, T>(image, width, height, table);
+  for (size_t y = 0; y < height; y++) {
+    for (size_t x = 0; x < width; x++) {
+      i64 expected = 0;
+      for (size_t j = 0; j <= y; j++) {
+        for (size_t i = 0; i <= x; i++) {
+          expected += image[j * width + i];
+        }
+      }
+      EXPECT(expected == static_cast<i64>(table[y * width + x]));
+    }
+  }
+}
+
+void TestTable() {
+  for (const size_t width : {size_t{1}, size_t{3}, size_t{16}, size_t{40}}) {
+    for (const size_t height : {size_t{1}, size_t{2}, size_t{16}}) {
+      vector<u8> pixels(width * height);
+      vector<i8> signed_pixels(width * height);
+      for (size_t i = 0; i < pixels.size(); i++) {
+        pixels[i] = static_cast<u8>(i * 37);
+        signed_pixels[i] = static_cast<i8>(i * 37);
+      }
+      TestTablePair<u32, u8>(width, height, pixels);
+      TestTablePair<u64, u8>(width, height, pixels);
+      TestTablePair<i32, i8>(width, height, signed_pixels);
+      TestTablePair<i64, i8>(width, height, signed_pixels);
+    }
+  }
+
+  vector<u8> empty;
+  TestTablePair<u32, u8>(0, 0, empty);
+  TestTablePair<u32, u8>(0, 5, empty);
+
+  const vector<u8> pixels = {1, 2, 3, 4, 5, 6};
+  vector<u32> table(6);
+  summed_area_table<u32, u8>(pixels, 3, 2, table);
+  EXPECT((vector<u32>{1, 3, 6, 5, 12, 21}) == table);
+  EXPECT_DEATH((summed_area_table<u32, u8>(pixels, 2, 2, table)));
+  EXPECT_DEATH((summed_area_table<u32, u8>(pixels, 3, 2,
+                                           span<u32>(table).first(5))));
+}
+
+// Tables that `R` is not proven wide enough for, but the pixels are.
+void TestPixelRange() {
+  vector<u8> pixels(17 * 16, 200);
+  TestTablePair<u16, u8>(17, 16, pixels);
+  pixels[100] = 255;
+  vector<u16> table(17 * 16);
+  EXPECT_DEATH((summed_area_table<u16, u8>(pixels, 17, 16, table)));
+
+  vector<i8> signed_pixels(16 * 17, -100);
+  TestTablePair<i16, i8>(16, 17, signed_pixels);
+  signed_pixels[0] = -128;
+  vector<i16> signed_table(16 * 17);
+  EXPECT_DEATH(
+      (summed_area_table<i16, i8>(signed_pixels, 16, 17, signed_table)));
+}
+
+}  // namespace
+
+int main() {
+  TestFits();
+  TestTable();
+  TestPixelRange();
+}
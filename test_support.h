@@ -15,8 +15,11 @@
 #ifndef EXPECTATIONS_H_
 #define EXPECTATIONS_H_
 
+#include <assert.h>
 #include <err.h>
+#include <errno.h>
 #include <execinfo.h>
+#include <sys/wait.h>
 #include <unistd.h>
 
 #include <iostream>
@@ -15,6 +15,7 @@
 #ifndef TRAPPING_H_
 #define TRAPPING_H_
 
+#include <limits.h>
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -26,6 +27,8 @@
 
 #include "in_range.h"
 #include "is_integral.h"
+#include "overflow_status.h"
+#include "span.h"
 #include "trap.h"
 
 namespace internal {
@@ -185,8 +188,96 @@ template <typename T, typename U, typename R>
   return cast_truncate(dividend % divisor, result);
 }
 
+}  // namespace integers
+
+namespace internal {
+
+// These are equivalent to `add_overflow` and so on for operands and results of
+// the same type `T`, but are written with plain arithmetic (rather than the
+// compiler’s checked-arithmetic intrinsics) so that compilers can vectorize
+// loops of them.
+
+template <typename T>
+bool vector_add_overflow(T x, T y, T* result) {
+  using U = std::make_unsigned_t<T>;
+  const U sum = static_cast<U>(static_cast<U>(x) + static_cast<U>(y));
+  *result = static_cast<T>(sum);
+  if constexpr (std::is_signed_v<T>) {
+    // Overflow iff the operands have the same sign and the sum’s differs.
+    return static_cast<T>((static_cast<U>(x) ^ sum) &
+                          (static_cast<U>(y) ^ sum)) < 0;
+  } else {
+    return sum < x;
+  }
+}
+
+template <typename T>
+bool vector_sub_overflow(T x, T y, T* result) {
+  using U = std::make_unsigned_t<T>;
+  const U difference = static_cast<U>(static_cast<U>(x) - static_cast<U>(y));
+  *result = static_cast<T>(difference);
+  if constexpr (std::is_signed_v<T>) {
+    // Overflow iff the operands have different signs and the difference’s
+    // sign differs from `x`’s.
+    return static_cast<T>((static_cast<U>(x) ^ static_cast<U>(y)) &
+                          (static_cast<U>(x) ^ difference)) < 0;
+  } else {
+    return x < y;
+  }
+}
+
+template <typename T>
+bool vector_mul_overflow(T x, T y, T* result) {
+  if constexpr (sizeof(T) < sizeof(int64_t)) {
+    using W = std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>;
+    const W product = static_cast<W>(x) * static_cast<W>(y);
+    *result = static_cast<T>(product);
+    return !integers::in_range<T>(product);
+  } else {
+    // There is no wider type to vectorize with.
+    return integers::mul_overflow(x, y, result);
+  }
+}
+
+// Like `add_overflow`, `sub_overflow`, and `mul_overflow`, but use the
+// vectorizable versions above when the types allow.
+
+template <typename R, typename T, typename U>
+bool vectorizable_add_overflow(T x, U y, R* result) {
+  if constexpr (std::is_same_v<T, R> && std::is_same_v<U, R>) {
+    return vector_add_overflow(x, y, result);
+  } else {
+    return integers::add_overflow(x, y, result);
+  }
+}
+
+template <typename R, typename T, typename U>
+bool vectorizable_sub_overflow(T x, U y, R* result) {
+  if constexpr (std::is_same_v<T, R> && std::is_same_v<U, R>) {
+    return vector_sub_overflow(x, y, result);
+  } else {
+    return integers::sub_overflow(x, y, result);
+  }
+}
+
+template <typename R, typename T, typename U>
+bool vectorizable_mul_overflow(T x, U y, R* result) {
+  if constexpr (std::is_same_v<T, R> && std::is_same_v<U, R>) {
+    return vector_mul_overflow(x, y, result);
+  } else {
+    return integers::mul_overflow(x, y, result);
+  }
+}
+
+}  // namespace internal
+
+namespace integers {
+
 /// ## Trapping Operations
 ///
+/// If `INTEGERS_STICKY_OVERFLOW` is defined, these functions record overflow
+/// in the sticky overflow status instead of trapping. See overflow_status.h.
+///
 /// ### `trapping_cast`
 ///
 /// Converts `T`s to `R`s, and traps if `R` cannot hold the full `value`. (This
@@ -194,10 +285,15 @@ template <typename T, typename U, typename R>
 /// and `R` is unsigned.)
 template <typename R, typename T>
 R trapping_cast(T value) {
+#if defined(INTEGERS_STICKY_OVERFLOW)
+  const R result = static_cast<R>(value);
+  record_overflow(!in_range<R>(value), overflow_flags::cast);
+#else
   R result = 0;
   if (cast_truncate(value, &result)) {
     trap();
   }
+#endif
   return result;
 }
 
@@ -212,9 +308,14 @@ R trapping_add(T x, U y) {
   assert_is_integral(U);
 
   R result = 0;
+#if defined(INTEGERS_STICKY_OVERFLOW)
+  record_overflow(internal::vectorizable_add_overflow(x, y, &result),
+                  overflow_flags::add);
+#else
   if (add_overflow(x, y, &result)) {
     trap();
   }
+#endif
   return result;
 }
 
@@ -229,9 +330,14 @@ R trapping_mul(T x, U y) {
   assert_is_integral(U);
 
   R result = 0;
+#if defined(INTEGERS_STICKY_OVERFLOW)
+  record_overflow(internal::vectorizable_mul_overflow(x, y, &result),
+                  overflow_flags::mul);
+#else
   if (mul_overflow(x, y, &result)) {
     trap();
   }
+#endif
 
   return result;
 }
@@ -247,9 +353,14 @@ R trapping_sub(T x, U y) {
   assert_is_integral(U);
 
   R result = 0;
+#if defined(INTEGERS_STICKY_OVERFLOW)
+  record_overflow(internal::vectorizable_sub_overflow(x, y, &result),
+                  overflow_flags::sub);
+#else
   if (sub_overflow(x, y, &result)) {
     trap();
   }
+#endif
 
   return result;
 }
@@ -265,9 +376,14 @@ R trapping_div(T dividend, U divisor) {
   assert_is_integral(U);
 
   R result = 0;
+#if defined(INTEGERS_STICKY_OVERFLOW)
+  record_overflow(div_overflow(dividend, divisor, &result),
+                  overflow_flags::div);
+#else
   if (div_overflow(dividend, divisor, &result)) {
     trap();
   }
+#endif
   return result;
 }
 
@@ -282,9 +398,14 @@ R trapping_mod(T dividend, U divisor) {
   assert_is_integral(U);
 
   R result = 0;
+#if defined(INTEGERS_STICKY_OVERFLOW)
+  record_overflow(mod_overflow(dividend, divisor, &result),
+                  overflow_flags::mod);
+#else
   if (mod_overflow(dividend, divisor, &result)) {
     trap();
   }
+#endif
 
   return result;
 }
@@ -947,6 +1068,47 @@ static_assert(sizeof(trapping<int32_t>) == sizeof(int32_t),
 static_assert(sizeof(trapping<int64_t>) == sizeof(int64_t),
               "sizeof(trapping<int64_t>) must == sizeof(int64_t)");
 
+/// ## Policy Views
+///
+/// `trapping<T>`, `wrapping<T>`, and `clamping<T>` have the same layout as
+/// `T`, so a buffer of `T`s can be viewed as any of them, and back, without
+/// copying. Switching the arithmetic policy of a large (e.g. memory-mapped)
+/// array is then free:
+///
+///   std::span<uint32_t> column = ...;
+///   for (trapping<uint32_t>& x : as_trapping(column)) {
+///     x *= 3;
+///   }
+///
+/// Give `T` explicitly when passing containers, and make it `const` for a
+/// read-only view, e.g. `as_clamping<const int16_t>(samples)`.
+///
+/// ### `as_trapping`
+///
+/// Returns a view of `values` as `trapping<T>`s, without copying.
+template <typename T>
+span<internal::rewrapped_t<trapping, T>> as_trapping(span<T> values) {
+  return internal::span_cast<internal::rewrapped_t<trapping, T>>(values);
+}
+
+/// ### `as_underlying`
+///
+/// Returns a view of `values` as plain `T`s, without copying. The inverse of
+/// `as_trapping`.
+template <typename T>
+span<T> as_underlying(span<trapping<T>> values) {
+  return internal::span_cast<T>(values);
+}
+
+/// ### `as_underlying`
+///
+/// Returns a view of `values` as plain `T`s, without copying. The inverse of
+/// `as_trapping`.
+template <typename T>
+span<const T> as_underlying(span<const trapping<T>> values) {
+  return internal::span_cast<const T>(values);
+}
+
 }  // namespace integers
 
 #endif  // TRAPPING_H_
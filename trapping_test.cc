@@ -14,6 +14,7 @@
 
 #include <iostream>
 #include <limits>
+#include <vector>
 
 #include "test_support.h"
 #include "trapping.h"
@@ -1160,6 +1161,23 @@ void TestAbs() {
   CallGenericTestAbs<i8, u8, i16, u16, i32, u32, i64, u64>();
 }
 
+void TestViews() {
+  vector<u32> column{1, 2, 3};
+  for (trapping<u32>& x : as_trapping<u32>(column)) {
+    x *= 3;
+  }
+  EXPECT(9 == column[2]);
+  EXPECT(column.data() == as_underlying(as_trapping<u32>(column)).data());
+
+  const span<const trapping<u32>> view = as_trapping<const u32>(column);
+  EXPECT(static_cast<const void*>(column.data()) == view.data());
+  EXPECT(6 == view[1]);
+  EXPECT(column.data() == as_underlying(view).data());
+
+  column[0] = numeric_limits<u32>::max();
+  EXPECT_DEATH(as_trapping<u32>(column)[0] += 1);
+}
+
 }  // namespace
 
 int main() {
@@ -1214,4 +1232,6 @@ int main() {
 
   TestOstream();
   TestAbs();
+
+  TestViews();
 }
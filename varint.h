@@ -0,0 +1,318 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef VARINT_H_
+#define VARINT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <limits>
+#include <type_traits>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+#include "in_range.h"
+#include "is_integral.h"
+#include "overflow_status.h"
+#include "span.h"
+#include "trap.h"
+#include "trapping.h"
+
+namespace internal {
+
+constexpr uint64_t kVarintLowBits = 0x7F7F7F7F7F7F7F7Fu;
+constexpr uint64_t kVarintHighBits = 0x8080808080808080u;
+
+// Gathers the low 7 bits of each byte of `word` into the low 56 bits of the
+// result, least significant byte first. With BMI2 this is `pext`; otherwise,
+// three rounds of closing the gaps between pairs of groups.
+inline uint64_t varint_compact(uint64_t word) {
+#if defined(__BMI2__)
+  return _pext_u64(word, kVarintLowBits);
+#else
+  word &= kVarintLowBits;
+  word = (word & 0x007F007F007F007Fu) | ((word & 0x7F007F007F007F00u) >> 1);
+  word = (word & 0x00003FFF00003FFFu) | ((word & 0x3FFF00003FFF0000u) >> 2);
+  return (word & 0x000000000FFFFFFFu) | ((word & 0x0FFFFFFF00000000u) >> 4);
+#endif
+}
+
+// Decodes a varint of at most 8 bytes from the 8 bytes at `bytes`, a word at a
+// time: the first byte without its high bit set ends the varint, and the
+// bytes after it are masked off. Returns the length, or 0 if the varint is
+// longer than 8 bytes. (Such a varint has at most 56 bits, so it always fits
+// `uint64_t`.)
+inline size_t varint_decode_word(const uint8_t* bytes, uint64_t* value) {
+  uint64_t word;
+  memcpy(&word, bytes, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  word = __builtin_bswap64(word);
+#endif
+  const uint64_t ends = ~word & kVarintHighBits;
+  if (ends == 0) {
+    return 0;
+  }
+  // `ends ^ (ends - 1)` is the bits up to and including the first end.
+  *value = varint_compact(word & (ends ^ (ends - 1)));
+  return static_cast<size_t>(__builtin_ctzll(ends)) / 8 + 1;
+}
+
+// Decodes a varint a byte at a time. Returns the length, or 0 if `bytes` ends
+// before the varint does. Stores the low 64 bits of the value in `*value`, and
+// sets `*overflow` if it has more.
+inline size_t varint_decode_bytes(const uint8_t* bytes,
+                                  size_t size,
+                                  uint64_t* value,
+                                  bool* overflow) {
+  uint64_t result = 0;
+  bool lost = false;
+  for (size_t i = 0; i < size; i++) {
+    const uint64_t group = bytes[i] & 0x7Fu;
+    if (i < 9) {
+      result |= group << (7 * i);
+    } else if (i == 9) {
+      // Only the lowest bit of the 10th byte is within 64 bits.
+      result |= group << 63;
+      lost |= group > 1;
+    } else {
+      lost |= group != 0;
+    }
+    if (bytes[i] < 0x80) {
+      *value = result;
+      *overflow = lost;
+      return i + 1;
+    }
+  }
+  return 0;
+}
+
+// Decodes a varint from `bytes[0, size)`, by the word if there are 8 bytes to
+// read and the varint is in them, and otherwise by the byte.
+inline size_t varint_decode(const uint8_t* bytes,
+                            size_t size,
+                            uint64_t* value,
+                            bool* overflow) {
+  if (size >= sizeof(uint64_t)) {
+    const size_t length = varint_decode_word(bytes, value);
+    if (length != 0) {
+      *overflow = false;
+      return length;
+    }
+  }
+  return varint_decode_bytes(bytes, size, value, overflow);
+}
+
+// Handles a decoded `value` per the trapping policy: `trap`s if it does not fit
+// `R` (or, in sticky mode, records `overflow_flags::cast` and truncates it).
+template <typename R>
+R varint_trapping_result(uint64_t value, bool overflow) {
+  const bool bad = overflow || !integers::in_range<R>(value);
+#if defined(INTEGERS_STICKY_OVERFLOW)
+  integers::record_overflow(bad, integers::overflow_flags::cast);
+#else
+  if (bad) {
+    trap();
+  }
+#endif
+  return static_cast<R>(value);
+}
+
+}  // namespace internal
+
+namespace integers {
+
+/// ## LEB128 Varints
+///
+/// An unsigned LEB128 varint stores an integer in 7-bit groups, least
+/// significant first, one per byte; the high bit of each byte is set if
+/// another byte follows. Small values take few bytes: values below 128 take
+/// one, and any `uint64_t` takes at most 10. (For signed values, zigzag-encode
+/// them first; see delta.h.)
+///
+/// The decoders reject values that `R` cannot represent, including those with
+/// bits beyond 64 (such as a 10th byte above 1), and varints cut off by the
+/// end of the input. They read a varint of up to 8 bytes as one word, with
+/// `pext` if the target has BMI2 (e.g. with `-march=native`), and read the
+/// longer ones, and those near the end of the input, a byte at a time.
+///
+/// ### `max_varint_size`
+///
+/// The most bytes that the varint of any non-negative `T` takes.
+template <typename T>
+constexpr size_t max_varint_size =
+    (static_cast<size_t>(std::numeric_limits<T>::digits) + 6) / 7;
+
+/// ### `varint_size`
+///
+/// Returns the number of bytes that the varint of `value` takes. `trap`s if
+/// `value` is negative.
+template <typename T>
+constexpr size_t varint_size(T value) {
+  assert_is_integral(T);
+  if (!in_range<std::make_unsigned_t<T>>(value)) {
+    trap();
+  }
+  auto bits = static_cast<std::make_unsigned_t<T>>(value);
+  size_t size = 1;
+  for (; bits >= 0x80; bits >>= 7) {
+    size++;
+  }
+  return size;
+}
+
+/// ### `varint_decode`
+///
+/// Decodes the varint at the start of `bytes` into `*result`, and returns its
+/// length in bytes. Returns 0, and leaves `*result` unchanged, if `bytes` does
+/// not start with a whole varint or if `R` cannot represent its value.
+template <typename R>
+[[nodiscard]] size_t varint_decode(span<const uint8_t> bytes, R* result) {
+  assert_is_integral(R);
+  uint64_t value;
+  bool overflow;
+  const size_t length =
+      internal::varint_decode(bytes.data(), bytes.size(), &value, &overflow);
+  if (length == 0 || overflow || cast_truncate(value, result)) {
+    return 0;
+  }
+  return length;
+}
+
+/// ### `varint_decode`
+///
+/// Decodes consecutive varints from the start of `bytes` into `result`, until
+/// `result` is full or a varint is cut off or does not fit `R`. Returns the
+/// number of values decoded, and sets `*consumed` to the number of bytes they
+/// took. You must give `R` explicitly when passing containers.
+template <typename R>
+[[nodiscard]] size_t varint_decode(span<const uint8_t> bytes,
+                                   span<R> result,
+                                   size_t* consumed) {
+  assert_is_integral(R);
+  size_t offset = 0;
+  size_t count = 0;
+  for (; count < result.size(); count++) {
+    uint64_t value;
+    bool overflow;
+    const size_t length = internal::varint_decode(
+        bytes.data() + offset, bytes.size() - offset, &value, &overflow);
+    if (length == 0 || overflow || cast_truncate(value, &result[count])) {
+      break;
+    }
+    offset += length;
+  }
+  *consumed = offset;
+  return count;
+}
+
+/// ### `trapping_varint_decode`
+///
+/// Decodes the varint at the start of `bytes` into `*result`, and returns its
+/// length in bytes. `trap`s if `bytes` does not start with a whole varint or
+/// if `R` cannot represent its value.
+///
+/// If `INTEGERS_STICKY_OVERFLOW` is defined, a value that `R` cannot represent
+/// is instead truncated, and recorded as `overflow_flags::cast`. (A varint cut
+/// off by the end of `bytes` still `trap`s, since there is nothing to
+/// truncate.)
+template <typename R>
+size_t trapping_varint_decode(span<const uint8_t> bytes, R* result) {
+  assert_is_integral(R);
+  uint64_t value;
+  bool overflow;
+  const size_t length =
+      internal::varint_decode(bytes.data(), bytes.size(), &value, &overflow);
+  if (length == 0) {
+    trap();
+  }
+  *result = internal::varint_trapping_result<R>(value, overflow);
+  return length;
+}
+
+/// ### `trapping_varint_decode`
+///
+/// Decodes `result.size()` consecutive varints from the start of `bytes` into
+/// `result`, and returns the number of bytes they took. `trap`s like the
+/// single-value `trapping_varint_decode`, and if `bytes` holds too few
+/// varints. You must give `R` explicitly when passing containers:
+///
+///   std::vector<uint32_t> lengths(count);
+///   const size_t used = trapping_varint_decode<uint32_t>(input, lengths);
+template <typename R>
+size_t trapping_varint_decode(span<const uint8_t> bytes, span<R> result) {
+  assert_is_integral(R);
+  size_t offset = 0;
+  for (R& x : result) {
+    uint64_t value;
+    bool overflow;
+    const size_t length = internal::varint_decode(
+        bytes.data() + offset, bytes.size() - offset, &value, &overflow);
+    if (length == 0) {
+      trap();
+    }
+    x = internal::varint_trapping_result<R>(value, overflow);
+    offset += length;
+  }
+  return offset;
+}
+
+/// ### `varint_encode`
+///
+/// Encodes `value` as a varint at the start of `out`, and returns the number of
+/// bytes written. `trap`s if `value` is negative or `out` is too small (see
+/// `varint_size` and `max_varint_size`).
+template <typename T>
+size_t varint_encode(T value, span<uint8_t> out) {
+  assert_is_integral(T);
+  if (!in_range<std::make_unsigned_t<T>>(value)) {
+    trap();
+  }
+  auto bits = static_cast<std::make_unsigned_t<T>>(value);
+  size_t i = 0;
+  for (; bits >= 0x80; bits >>= 7) {
+    if (i == out.size()) {
+      trap();
+    }
+    out[i++] = static_cast<uint8_t>(bits | 0x80);
+  }
+  if (i == out.size()) {
+    trap();
+  }
+  out[i++] = static_cast<uint8_t>(bits);
+  return i;
+}
+
+/// ### `varint_encode`
+///
+/// Encodes each element of `values` as a varint, consecutively at the start of
+/// `out`, and returns the number of bytes written. `trap`s if an element is
+/// negative or `out` is too small. (`values.size() * max_varint_size<T>` bytes
+/// are always enough.)
+template <typename T>
+size_t varint_encode(span<const T> values, span<uint8_t> out) {
+  assert_is_integral(T);
+  size_t offset = 0;
+  for (const T value : values) {
+    offset += varint_encode(value, out.subspan(offset));
+  }
+  return offset;
+}
+
+}  // namespace integers
+
+#endif  // VARINT_H_
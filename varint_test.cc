@@ -0,0 +1,200 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "test_support.h"
+#include "varint.h"
+
+using namespace integers;
+using namespace std;
+
+namespace {
+
+using i8 = int8_t;
+using u8 = uint8_t;
+using i16 = int16_t;
+using u16 = uint16_t;
+using i32 = int32_t;
+using u32 = uint32_t;
+using i64 = int64_t;
+using u64 = uint64_t;
+
+using Bytes = vector<u8>;
+
+void TestEncode() {
+  EXPECT(5 == max_varint_size<u32>);
+  EXPECT(10 == max_varint_size<u64>);
+  EXPECT(9 == max_varint_size<i64>);
+  EXPECT(2 == max_varint_size<u8>);
+
+  u8 out[10];
+  EXPECT(1 == varint_encode(u32{0}, out));
+  EXPECT(0 == out[0]);
+  EXPECT(2 == varint_encode(300, out));
+  EXPECT(0xAC == out[0] && 0x02 == out[1]);
+  EXPECT(3 == varint_encode(u64{624485}, out));
+  EXPECT(0xE5 == out[0] && 0x8E == out[1] && 0x26 == out[2]);
+  EXPECT(10 == varint_encode(numeric_limits<u64>::max(), out));
+  EXPECT(0xFF == out[8] && 0x01 == out[9]);
+
+  EXPECT(1 == varint_size(127));
+  EXPECT(2 == varint_size(128));
+  EXPECT(5 == varint_size(numeric_limits<u32>::max()));
+  EXPECT(9 == varint_size(numeric_limits<i64>::max()));
+
+  EXPECT_DEATH(varint_encode(-1, out));
+  EXPECT_DEATH(static_cast<void>(varint_size(i8{-1})));
+  EXPECT_DEATH(varint_encode(300, span<u8>(out, 1)));
+  EXPECT_DEATH(varint_encode(0, span<u8>()));
+}
+
+// Decodes `bytes` both with and without bytes after it, so that the values go
+// through the word-at-a-time and the byte-at-a-time paths.
+template <typename R>
+size_t DecodeBothWays(const Bytes& bytes, R* result) {
+  Bytes padded = bytes;
+  padded.resize(bytes.size() + 8, 0xFF);
+  R padded_result = 0;
+  const size_t padded_length = varint_decode<R>(padded, &padded_result);
+  const size_t length = varint_decode<R>(bytes, result);
+  EXPECT(length == padded_length);
+  EXPECT(length == 0 || padded_result == *result);
+  return length;
+}
+
+template <typename T>
+void GenericTestRoundTrip() {
+  constexpr T max = numeric_limits<T>::max();
+  vector<T> values{
+      0, 1, 127, max, static_cast<T>(max / 2), static_cast<T>(max - 1)};
+  for (int shift = 7; shift < numeric_limits<T>::digits; shift += 7) {
+    values.push_back(static_cast<T>(T{1} << shift));
+    values.push_back(static_cast<T>((T{1} << shift) - 1));
+  }
+  for (const T value : values) {
+    u8 out[max_varint_size<T>];
+    const size_t size = varint_encode(value, out);
+    EXPECT(varint_size(value) == size);
+    const Bytes bytes(out, out + size);
+    T decoded = 0;
+    EXPECT(size == DecodeBothWays(bytes, &decoded));
+    EXPECT(value == decoded);
+    T trapping_decoded = 0;
+    EXPECT(size == trapping_varint_decode<T>(bytes, &trapping_decoded));
+    EXPECT(value == trapping_decoded);
+
+    // Every prefix is cut off.
+    for (size_t i = 0; i < size; i++) {
+      EXPECT(0 == DecodeBothWays(Bytes(out, out + i), &decoded));
+    }
+  }
+}
+
+template <class... T>
+void CallGenericTestRoundTrip() {
+  (GenericTestRoundTrip<T>(), ...);
+}
+
+void TestRoundTrip() {
+  CallGenericTestRoundTrip<u8, i16, u16, i32, u32, i64, u64>();
+}
+
+void TestReject() {
+  u32 x32 = 42;
+  u64 x64 = 42;
+  i8 x8 = 42;
+
+  // Values that do not fit `R`.
+  EXPECT(0 == DecodeBothWays(Bytes{0x80, 0x80, 0x80, 0x80, 0x10}, &x32));
+  EXPECT(5 == DecodeBothWays(Bytes{0x80, 0x80, 0x80, 0x80, 0x08}, &x64));
+  EXPECT(0 == DecodeBothWays(Bytes{0x80, 0x01}, &x8));
+  EXPECT(1 == DecodeBothWays(Bytes{0x7F}, &x8));
+  EXPECT(42 == x32);
+
+  // A 10th byte above 1, or an 11th byte, sets bits beyond 64.
+  const Bytes max(9, 0xFF);
+  Bytes tenth = max;
+  tenth.push_back(0x01);
+  EXPECT(10 == DecodeBothWays(tenth, &x64));
+  EXPECT(numeric_limits<u64>::max() == x64);
+  tenth.back() = 0x02;
+  EXPECT(0 == DecodeBothWays(tenth, &x64));
+  Bytes eleventh = max;
+  eleventh.push_back(0x81);
+  eleventh.push_back(0x01);
+  EXPECT(0 == DecodeBothWays(eleventh, &x64));
+
+  // Redundant zero groups are accepted, as long as the value fits.
+  EXPECT(3 == DecodeBothWays(Bytes{0x81, 0x80, 0x00}, &x8));
+  EXPECT(1 == x8);
+  Bytes zeros(11, 0x80);
+  zeros.push_back(0x00);
+  EXPECT(12 == DecodeBothWays(zeros, &x64));
+  EXPECT(0 == x64);
+
+  EXPECT(0 == DecodeBothWays(Bytes{}, &x64));
+  EXPECT_DEATH(trapping_varint_decode<u64>(Bytes{0x80}, &x64));
+  EXPECT_DEATH(trapping_varint_decode<u64>(tenth, &x64));
+  EXPECT_DEATH(trapping_varint_decode<i8>(Bytes{0x80, 0x01}, &x8));
+}
+
+void TestStream() {
+  vector<u64> values;
+  u64 state = 3;
+  for (int i = 0; i < 1000; i++) {
+    state = state * 6364136223846793005u + 1442695040888963407u;
+    // Values of every length.
+    values.push_back(state >> (state % 64));
+  }
+  Bytes bytes(values.size() * max_varint_size<u64>);
+  const size_t size = varint_encode<u64>(values, bytes);
+  bytes.resize(size);
+
+  vector<u64> decoded(values.size());
+  EXPECT(size == trapping_varint_decode<u64>(bytes, decoded));
+  EXPECT(values == decoded);
+  size_t consumed = 0;
+  EXPECT(values.size() == varint_decode<u64>(bytes, decoded, &consumed));
+  EXPECT(size == consumed);
+  EXPECT(values == decoded);
+
+  // The checked decoder stops at the first value that does not fit, or that is
+  // cut off.
+  const Bytes mixed{0x05, 0xAC, 0x02, 0x80, 0x02, 0x07};
+  vector<u8> narrow(4);
+  EXPECT(1 == varint_decode<u8>(mixed, narrow, &consumed));
+  EXPECT(1 == consumed);
+  vector<u16> wide(4);
+  EXPECT(4 == varint_decode<u16>(mixed, wide, &consumed));
+  EXPECT(6 == consumed);
+  EXPECT((wide == vector<u16>{5, 300, 256, 7}));
+  wide.push_back(0);
+  EXPECT(4 == varint_decode<u16>(mixed, wide, &consumed));
+
+  EXPECT_DEATH(trapping_varint_decode<u16>(mixed, wide));
+  EXPECT_DEATH(trapping_varint_decode<u8>(mixed, narrow));
+  EXPECT_DEATH(varint_encode<u64>(values, span<u8>(bytes).first(size - 1)));
+}
+
+}  // namespace
+
+int main() {
+  TestEncode();
+  TestRoundTrip();
+  TestReject();
+  TestStream();
+}
@@ -0,0 +1,108 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef WIDE_H_
+#define WIDE_H_
+
+#include <stdint.h>
+
+#include <limits>
+#include <type_traits>
+
+#include "in_range.h"
+
+namespace internal {
+
+#if defined(__SIZEOF_INT128__)
+#define INTEGERS_HAVE_INT128 1
+__extension__ typedef __int128 int128_t;
+__extension__ typedef unsigned __int128 uint128_t;
+#endif
+
+/// Like `std::is_signed_v`, but also true for `int128_t`, which the standard
+/// library does not consider integral in strict standards mode.
+template <typename W>
+constexpr bool is_signed_wide_v = static_cast<W>(-1) < static_cast<W>(0);
+
+/// Selects the narrowest of the 32-, 64-, and (where the compiler provides
+/// them) 128-bit integer types that is at least `Bits` wide and has the given
+/// signedness. Types narrower than 32 bits are never selected, so that
+/// arithmetic on the result is not subject to integer promotion.
+template <int Bits, bool Signed>
+struct wide_integer {
+#if defined(INTEGERS_HAVE_INT128)
+  static_assert(Bits <= 128, "No integer type is wide enough");
+  using wide128 = std::conditional_t<Signed, int128_t, uint128_t>;
+#else
+  static_assert(Bits <= 64, "No integer type is wide enough");
+  using wide128 = void;
+#endif
+
+  using type = std::conditional_t<
+      Bits <= 32,
+      std::conditional_t<Signed, int32_t, uint32_t>,
+      std::conditional_t<Bits <= 64,
+                         std::conditional_t<Signed, int64_t, uint64_t>,
+                         wide128>>;
+};
+
+template <int Bits, bool Signed>
+using wide_integer_t = typename wide_integer<Bits, Signed>::type;
+
+/// Like `integers::in_range`, but `value` may also be one of the 128-bit
+/// types, which `std::in_range` does not accept.
+template <typename R, typename W>
+constexpr bool wide_in_range(W value) {
+  if constexpr (sizeof(W) <= sizeof(uint64_t)) {
+    return integers::in_range<R>(value);
+  } else if constexpr (std::is_signed_v<R> && is_signed_wide_v<W>) {
+    return static_cast<W>(std::numeric_limits<R>::min()) <= value &&
+           value <= static_cast<W>(std::numeric_limits<R>::max());
+  } else if constexpr (is_signed_wide_v<W>) {
+    return 0 <= value &&
+           value <= static_cast<W>(std::numeric_limits<R>::max());
+  } else {
+    return value <= static_cast<W>(std::numeric_limits<R>::max());
+  }
+}
+
+/// Like `integers::add_overflow` for operands and result of type `W`, but `W`
+/// may also be one of the 128-bit types.
+template <typename W>
+[[nodiscard]] bool wide_add_overflow(W x, W y, W* result) {
+#if __has_builtin(__builtin_add_overflow)
+  return __builtin_add_overflow(x, y, result);
+#else
+#error Use the compiler intrinsic for checked addition here.
+#endif
+}
+
+/// Converts `value` to `R`, saturating at `R`’s minimum or maximum. Accepts
+/// the 128-bit types, like `wide_in_range`.
+template <typename R, typename W>
+constexpr R wide_clamp(W value) {
+  if (wide_in_range<R>(value)) {
+    return static_cast<R>(value);
+  }
+  if constexpr (is_signed_wide_v<W>) {
+    if (value < 0) {
+      return std::numeric_limits<R>::min();
+    }
+  }
+  return std::numeric_limits<R>::max();
+}
+
+}  // namespace internal
+
+#endif  // WIDE_H_
@@ -15,14 +15,80 @@
 #ifndef WRAPPING_H_
 #define WRAPPING_H_
 
+#include <limits.h>
 #include <stdint.h>
 #include <stdlib.h>
 
 #include <algorithm>
 #include <limits>
+#include <ostream>
 #include <type_traits>
 
 #include "is_integral.h"
+#include "span.h"
+#include "trap.h"
+#include "trapping.h"
+#include "wide.h"
+
+namespace internal {
+
+// Returns `value` with its bytes in reverse order.
+template <typename T>
+constexpr T reverse_bytes(T value) {
+  using U = std::make_unsigned_t<T>;
+  const U bits = static_cast<U>(value);
+  if constexpr (sizeof(T) == 1) {
+    return value;
+  } else if constexpr (sizeof(T) == 2) {
+    return static_cast<T>(__builtin_bswap16(bits));
+  } else if constexpr (sizeof(T) == 4) {
+    return static_cast<T>(__builtin_bswap32(bits));
+  } else {
+    static_assert(sizeof(T) == 8, "Unsupported integer size.");
+    return static_cast<T>(__builtin_bswap64(bits));
+  }
+}
+
+// Returns `bits` rotated left by `count` modulo its width. Compilers turn
+// this into one rotate instruction.
+template <typename U>
+constexpr U rotate_left(U bits, unsigned count) {
+  using Promoted = std::common_type_t<U, unsigned>;
+  constexpr unsigned kMask = std::numeric_limits<U>::digits - 1;
+  const Promoted x = bits;
+  count &= kMask;
+  return static_cast<U>((x << count) | (x >> ((0u - count) & kMask)));
+}
+
+// Returns the high half of the double-width product of `x` and `y`.
+template <typename U>
+constexpr U multiply_high(U x, U y) {
+  constexpr int kBits = std::numeric_limits<U>::digits;
+  if constexpr (kBits <= 32) {
+    return static_cast<U>((uint64_t{x} * uint64_t{y}) >> kBits);
+  } else {
+    static_assert(kBits == 64, "Unsupported integer size.");
+#if defined(INTEGERS_HAVE_INT128)
+    return static_cast<U>((uint128_t{x} * uint128_t{y}) >> 64);
+#else
+    // Schoolbook multiplication of 32-bit halves. `middle` gathers the
+    // carries into the high half, and cannot overflow.
+    const uint64_t x_low = static_cast<uint32_t>(x);
+    const uint64_t x_high = x >> 32;
+    const uint64_t y_low = static_cast<uint32_t>(y);
+    const uint64_t y_high = y >> 32;
+    const uint64_t low_low = x_low * y_low;
+    const uint64_t high_low = x_high * y_low;
+    const uint64_t low_high = x_low * y_high;
+    const uint64_t middle = (low_low >> 32) + static_cast<uint32_t>(high_low) +
+                            static_cast<uint32_t>(low_high);
+    return x_high * y_high + (high_low >> 32) + (low_high >> 32) +
+           (middle >> 32);
+#endif
+  }
+}
+
+}  // namespace internal
 
 namespace integers {
 
@@ -34,10 +100,10 @@ namespace integers {
 /// cannot fit into type `R`, this function will wrap.
 template <typename T, typename U, typename R>
 R wrapping_add(const T& x, const U& y) {
-  // TODO
-  (void)x;
-  (void)y;
-  return 0;
+  // The intrinsics store the wrapped result even when they report overflow.
+  R result;
+  static_cast<void>(add_overflow(x, y, &result));
+  return result;
 }
 
 /// ### `wrapping_mul`
@@ -46,10 +112,9 @@ R wrapping_add(const T& x, const U& y) {
 /// or cannot fit into type `R`, this function will wrap.
 template <typename T, typename U, typename R>
 R wrapping_mul(const T& x, const U& y) {
-  // TODO
-  (void)x;
-  (void)y;
-  return 0;
+  R result;
+  static_cast<void>(mul_overflow(x, y, &result));
+  return result;
 }
 
 /// ### `wrapping_sub`
@@ -58,41 +123,51 @@ R wrapping_mul(const T& x, const U& y) {
 /// or cannot fit into type `R`, this function will wrap.
 template <typename T, typename U, typename R>
 R wrapping_sub(const T& x, const U& y) {
-  // TODO
-  (void)x;
-  (void)y;
-  return 0;
+  R result;
+  static_cast<void>(sub_overflow(x, y, &result));
+  return result;
 }
 
 /// ### `wrapping_div`
 ///
 /// Divides `dividend` by `divisor` and returns the quotient. If the operation
-/// overflows, or cannot fit into type `R`, this function will wrap.
+/// overflows, or cannot fit into type `R`, this function will wrap. (Only
+/// dividing the minimum value of a signed type by -1 overflows; the quotient
+/// wraps to the minimum value.) `trap`s if `divisor` is 0.
 template <typename T, typename U, typename R>
 R wrapping_div(const T& dividend, const U& divisor) {
-  // TODO
-  (void)dividend;
-  (void)divisor;
-  return 0;
+  if (divisor == 0) {
+    trap();
+  }
+  if (internal::check_bad_division<T, U>(dividend, divisor)) {
+    return wrapping_sub<int, T, R>(0, dividend);
+  }
+  return static_cast<R>(dividend / divisor);
 }
 
 /// ### `wrapping_mod`
 ///
 /// Divides `dividend` by `divisor` and returns the remainder. If the operation
-/// overflows, or cannot fit into type `R`, this function will wrap.
+/// overflows, or cannot fit into type `R`, this function will wrap. `trap`s if
+/// `divisor` is 0.
 template <typename T, typename U, typename R>
 R wrapping_mod(const T& dividend, const U& divisor) {
-  // TODO
-  (void)dividend;
-  (void)divisor;
-  return 0;
+  if (divisor == 0) {
+    trap();
+  }
+  if (internal::check_bad_division<T, U>(dividend, divisor)) {
+    return 0;
+  }
+  return static_cast<R>(dividend % divisor);
 }
 
 /// ## `wrapping<T>`
 ///
 /// This template class implements integer types with well-defined behavior on
 /// overflow, underflow, bit-shifting too far, and narrowing conversions. For
-/// each of those phenomena, this implementation will wrap.
+/// each of those phenomena, this implementation will wrap. (Shift counts wrap
+/// modulo the number of bits in `T`.) Division by 0 still `trap`s, since no
+/// result could be meaningful.
 ///
 /// This implementation works by casting `T` to the `unsigned` equivalent (using
 /// `make_unsigned`), which the C++ standard defines to not overflow (see
@@ -111,11 +186,547 @@ class wrapping {
 
   using Self = wrapping<T>;
 
+  // Arithmetic on `Unsigned` wraps, and is not subject to integer promotion
+  // to (signed) `int`.
+  using Unsigned = std::common_type_t<std::make_unsigned_t<T>, unsigned int>;
+
+  static constexpr Unsigned kShiftMask = CHAR_BIT * sizeof(T) - 1;
+
  public:
+  /// ### `wrapping`
+  ///
+  /// The default constructor. The contents of the object are undefined. 😕
+  /// Best practice is to use `-ftrivial-auto-var-init=zero` or to
+  /// explicitly initialize the object.
+  wrapping() = default;
+
+  /// ### `wrapping`
+  ///
+  /// Constructs and initializes.
+  template <typename U, std::enable_if_t<std::is_same_v<T, U>, int> = 0>
+  wrapping(U value) : value_(value) {}
+
+  /// ### `wrapping`
+  ///
+  /// Constructs and initializes. If `T` cannot represent `value`, wraps it
+  /// modulo 2 to the number of bits in `T`.
+  template <typename U, std::enable_if_t<!std::is_same_v<T, U>, int> = 0>
+  explicit wrapping(U value) : value_(static_cast<T>(value)) {
+    assert_is_integral(U);
+  }
+
+  /// ### `operator+=`
+  ///
+  /// Increments by `x`, wrapping on overflow.
+  Self& operator+=(Self x) {
+    value_ = Wrap(Unsigned(value_) + Unsigned(x.value_));
+    return *this;
+  }
+
+  /// ### `operator+`
+  ///
+  /// Adds `rhs` to `lhs`, assigns the result to `lhs`, and returns it. Wraps
+  /// on overflow.
+  friend Self operator+(Self lhs, Self rhs) {
+    lhs += rhs;
+    return lhs;
+  }
+
+  /// ### `operator+`
+  ///
+  /// Adds `rhs` to `lhs`, assigns the result to `lhs`, and returns it. Wraps
+  /// on overflow.
+  template <typename U>
+  friend Self operator+(Self lhs, U rhs) {
+    lhs += Self{rhs};
+    return lhs;
+  }
+
+  /// ### `operator+`
+  ///
+  /// Adds `rhs` to `lhs`, assigns the result to `lhs`, and returns it. Wraps
+  /// on overflow.
+  template <typename U>
+  friend Self operator+(U lhs, Self rhs) {
+    Self result{lhs};
+    result += rhs;
+    return result;
+  }
+
+  /// ### `operator-=`
+  ///
+  /// Subtracts `x`, wrapping on overflow.
+  Self& operator-=(Self x) {
+    value_ = Wrap(Unsigned(value_) - Unsigned(x.value_));
+    return *this;
+  }
+
+  /// ### `operator-`
+  ///
+  /// Subtracts `rhs` from `lhs`, assigns the result to `lhs`, and returns
+  /// it. Wraps on overflow.
+  friend Self operator-(Self lhs, Self rhs) {
+    lhs -= rhs;
+    return lhs;
+  }
+
+  /// ### `operator-`
+  ///
+  /// Subtracts `rhs` from `lhs`, assigns the result to `lhs`, and returns
+  /// it. Wraps on overflow.
+  template <typename U>
+  friend Self operator-(Self lhs, U rhs) {
+    lhs -= Self{rhs};
+    return lhs;
+  }
+
+  /// ### `operator-`
+  ///
+  /// Subtracts `rhs` from `lhs`, assigns the result to `lhs`, and returns
+  /// it. Wraps on overflow.
+  template <typename U>
+  friend Self operator-(U lhs, Self rhs) {
+    Self result{lhs};
+    result -= rhs;
+    return result;
+  }
+
+  /// ### `operator+`
+  ///
+  /// Does nothing. (But it’s explicit about it!)
+  Self operator+() const { return *this; }
+
+  /// ### `operator-`
+  ///
+  /// Returns the value with its sign reversed, wrapping. (The minimum value of
+  /// a signed `T` is its own negation, and unsigned values negate modulo 2 to
+  /// the number of bits in `T`.)
+  Self operator-() const { return Self{Wrap(Unsigned{0} - Unsigned(value_))}; }
+
+  /// ### `operator*=`
+  ///
+  /// Multiplies by `x`, wrapping on overflow.
+  Self& operator*=(Self x) {
+    value_ = Wrap(Unsigned(value_) * Unsigned(x.value_));
+    return *this;
+  }
+
+  /// ### `operator*`
+  ///
+  /// Multiplies `lhs` by `rhs`, assigns the result to `lhs`, and returns
+  /// it. Wraps on overflow.
+  friend Self operator*(Self lhs, Self rhs) {
+    lhs *= rhs;
+    return lhs;
+  }
+
+  /// ### `operator*`
+  ///
+  /// Multiplies `lhs` by `rhs`, assigns the result to `lhs`, and returns
+  /// it. Wraps on overflow.
+  template <typename U>
+  friend Self operator*(Self lhs, U rhs) {
+    lhs *= Self{rhs};
+    return lhs;
+  }
+
+  /// ### `operator*`
+  ///
+  /// Multiplies `lhs` by `rhs`, assigns the result to `lhs`, and returns
+  /// it. Wraps on overflow.
+  template <typename U>
+  friend Self operator*(U lhs, Self rhs) {
+    Self result{lhs};
+    result *= rhs;
+    return result;
+  }
+
+  /// ### `operator/=`
+  ///
+  /// Divides by `divisor`, storing the quotient in `*this`. Wraps on overflow,
+  /// and `trap`s if `divisor` is 0.
+  Self& operator/=(Self divisor) {
+    value_ = wrapping_div<T, T, T>(value_, divisor.value_);
+    return *this;
+  }
+
+  /// ### `operator/`
+  ///
+  /// Divides `dividend` by `divisor`, storing the quotient in `dividend`, and
+  /// returns `dividend`. Wraps on overflow, and `trap`s if `divisor` is 0.
+  friend Self operator/(Self dividend, Self divisor) {
+    dividend /= divisor;
+    return dividend;
+  }
+
+  /// ### `operator/`
+  ///
+  /// Divides `dividend` by `divisor`, storing the quotient in `dividend`, and
+  /// returns `dividend`. Wraps on overflow, and `trap`s if `divisor` is 0.
+  template <typename U>
+  friend Self operator/(Self dividend, U divisor) {
+    dividend /= Self{divisor};
+    return dividend;
+  }
+
+  /// ### `operator/`
+  ///
+  /// Divides `dividend` by `divisor`, storing the quotient in `dividend`, and
+  /// returns `dividend`. Wraps on overflow, and `trap`s if `divisor` is 0.
+  template <typename U>
+  friend Self operator/(U dividend, Self divisor) {
+    Self result{dividend};
+    result /= divisor;
+    return result;
+  }
+
+  /// ### `operator%=`
+  ///
+  /// Divides by `divisor`, storing the remainder in `*this`. `trap`s if
+  /// `divisor` is 0.
+  Self& operator%=(Self divisor) {
+    value_ = wrapping_mod<T, T, T>(value_, divisor.value_);
+    return *this;
+  }
+
+  /// ### `operator%`
+  ///
+  /// Divides `dividend` by `divisor`, storing the remainder in `dividend`, and
+  /// returns `dividend`. `trap`s if `divisor` is 0.
+  friend Self operator%(Self dividend, Self divisor) {
+    dividend %= divisor;
+    return dividend;
+  }
+
+  /// ### `operator%`
+  ///
+  /// Divides `dividend` by `divisor`, storing the remainder in `dividend`, and
+  /// returns `dividend`. `trap`s if `divisor` is 0.
+  template <typename U>
+  friend Self operator%(Self dividend, U divisor) {
+    dividend %= Self{divisor};
+    return dividend;
+  }
+
+  /// ### `operator%`
+  ///
+  /// Divides `dividend` by `divisor`, storing the remainder in `dividend`, and
+  /// returns `dividend`. `trap`s if `divisor` is 0.
+  template <typename U>
+  friend Self operator%(U dividend, Self divisor) {
+    Self result{dividend};
+    result %= divisor;
+    return result;
+  }
+
+  /// ### `operator|=`
+  ///
+  /// Takes the bitwise `|` of the value and `x`, and assigns it to `value_`.
+  /// Returns `*this`.
+  Self& operator|=(Self x) {
+    value_ = static_cast<T>(value_ | x.value_);
+    return *this;
+  }
+
+  /// ### `operator|`
+  ///
+  /// Takes the bitwise `|` of `lhs` and `rhs`, assigns it to `lhs`, and returns
+  /// it.
+  friend Self operator|(Self lhs, Self rhs) {
+    lhs |= rhs;
+    return lhs;
+  }
+
+  /// ### `operator|`
+  ///
+  /// Takes the bitwise `|` of `lhs` and `rhs` (wrapped to `T`), assigns it
+  /// to `lhs`, and returns it.
+  template <typename U>
+  friend Self operator|(Self lhs, U rhs) {
+    lhs |= Self{rhs};
+    return lhs;
+  }
+
+  /// ### `operator|`
+  ///
+  /// Takes the bitwise `|` of `lhs` and `rhs` (wrapped to `T`), assigns it
+  /// to `lhs`, and returns it.
+  template <typename U>
+  friend Self operator|(U lhs, Self rhs) {
+    Self result{lhs};
+    result |= rhs;
+    return result;
+  }
+
+  /// ### `operator&=`
+  ///
+  /// Takes the bitwise `&` of the value and `x`, and assigns it to `value_`.
+  /// Returns `*this`.
+  Self& operator&=(Self x) {
+    value_ = static_cast<T>(value_ & x.value_);
+    return *this;
+  }
+
+  /// ### `operator&`
+  ///
+  /// Takes the bitwise `&` of `lhs` and `rhs`, assigns it to `lhs`, and returns
+  /// it.
+  friend Self operator&(Self lhs, Self rhs) {
+    lhs &= rhs;
+    return lhs;
+  }
+
+  /// ### `operator&`
+  ///
+  /// Takes the bitwise `&` of `lhs` and `rhs` (wrapped to `T`), assigns it
+  /// to `lhs`, and returns it.
+  template <typename U>
+  friend Self operator&(Self lhs, U rhs) {
+    lhs &= Self{rhs};
+    return lhs;
+  }
+
+  /// ### `operator&`
+  ///
+  /// Takes the bitwise `&` of `lhs` and `rhs` (wrapped to `T`), assigns it
+  /// to `lhs`, and returns it.
+  template <typename U>
+  friend Self operator&(U lhs, Self rhs) {
+    Self result{lhs};
+    result &= rhs;
+    return result;
+  }
+
+  /// ### `operator^=`
+  ///
+  /// Takes the bitwise `^` of the value and `x`, and assigns it to `value_`.
+  /// Returns `*this`.
+  Self& operator^=(Self x) {
+    value_ = static_cast<T>(value_ ^ x.value_);
+    return *this;
+  }
+
+  /// ### `operator^`
+  ///
+  /// Takes the bitwise `^` of `lhs` and `rhs`, assigns it to `lhs`, and returns
+  /// it.
+  friend Self operator^(Self lhs, Self rhs) {
+    lhs ^= rhs;
+    return lhs;
+  }
+
+  /// ### `operator^`
+  ///
+  /// Takes the bitwise `^` of `lhs` and `rhs` (wrapped to `T`), assigns it
+  /// to `lhs`, and returns it.
+  template <typename U>
+  friend Self operator^(Self lhs, U rhs) {
+    lhs ^= Self{rhs};
+    return lhs;
+  }
+
+  /// ### `operator^`
+  ///
+  /// Takes the bitwise `^` of `lhs` and `rhs` (wrapped to `T`), assigns it
+  /// to `lhs`, and returns it.
+  template <typename U>
+  friend Self operator^(U lhs, Self rhs) {
+    Self result{lhs};
+    result ^= rhs;
+    return result;
+  }
+
+  /// ### `operator~`
+  ///
+  /// Returns the bitwise complement of the value.
+  Self operator~() const { return Self{Wrap(~Unsigned(value_))}; }
+
+  /// ### `operator<<=`
+  ///
+  /// Shifts the value left by `count` modulo the number of bits in `T`, and
+  /// assigns the result to `value_`. Bits shifted off the left are discarded.
+  /// Returns `*this`.
+  Self& operator<<=(int count) {
+    value_ = Wrap(Unsigned(value_) << (Unsigned(count) & kShiftMask));
+    return *this;
+  }
+
+  /// ### `operator<<`
+  ///
+  /// Shifts `lhs` left by `count` modulo the number of bits in `T`, and
+  /// returns it.
+  friend Self operator<<(Self lhs, int count) {
+    lhs <<= count;
+    return lhs;
+  }
+
+  /// ### `operator>>=`
+  ///
+  /// Shifts the value right by `count` modulo the number of bits in `T`, and
+  /// assigns the result to `value_`. The shift is arithmetic (copies the sign
+  /// bit) if `T` is signed. Returns `*this`.
+  Self& operator>>=(int count) {
+    value_ = static_cast<T>(value_ >> (Unsigned(count) & kShiftMask));
+    return *this;
+  }
+
+  /// ### `operator>>`
+  ///
+  /// Shifts `lhs` right by `count` modulo the number of bits in `T`, and
+  /// returns it.
+  friend Self operator>>(Self lhs, int count) {
+    lhs >>= count;
+    return lhs;
+  }
+
+  /// ### `operator++`
+  ///
+  /// Prefix increment. Increments the value, wrapping, and returns `*this`
+  /// with the new value.
+  Self& operator++() {
+    *this += Self{T{1}};
+    return *this;
+  }
+
+  /// ### `operator++`
+  ///
+  /// Postfix increment. Increments the value, wrapping, and returns an object
+  /// containing the previous value.
+  Self operator++(int) {
+    Self previous = *this;
+    ++*this;
+    return previous;
+  }
+
+  /// ### `operator--`
+  ///
+  /// Prefix decrement. Decrements the value, wrapping, and returns `*this`
+  /// with the new value.
+  Self& operator--() {
+    *this -= Self{T{1}};
+    return *this;
+  }
+
+  /// ### `operator--`
+  ///
+  /// Postfix decrement. Decrements the value, wrapping, and returns an object
+  /// containing the previous value.
+  Self operator--(int) {
+    Self previous = *this;
+    --*this;
+    return previous;
+  }
+
+  /// ### `operator==`
+  ///
+  /// Returns true if `lhs` and `rhs` are equal.
+  friend bool operator==(Self lhs, Self rhs) {
+    return lhs.value_ == rhs.value_;
+  }
+
+  /// ### `operator!=`
+  ///
+  /// Returns true if `lhs` and `rhs` are not equal.
+  friend bool operator!=(Self lhs, Self rhs) { return !(lhs == rhs); }
+
+  /// ### `operator<`
+  ///
+  /// Returns true if `lhs` is less than `rhs`.
+  friend bool operator<(Self lhs, Self rhs) { return lhs.value_ < rhs.value_; }
+
+  /// ### `operator<`
+  ///
+  /// Returns true if `lhs` is less than `rhs`.
+  friend bool operator<(Self lhs, T rhs) { return lhs.value_ < rhs; }
+
+  /// ### `operator<`
+  ///
+  /// Returns true if `lhs` is less than `rhs`.
+  friend bool operator<(T lhs, Self rhs) { return lhs < rhs.value_; }
+
+  /// ### `operator>`
+  ///
+  /// Returns true if `lhs` is greater than `rhs`.
+  friend bool operator>(Self lhs, Self rhs) { return rhs < lhs; }
+
+  /// ### `operator>`
+  ///
+  /// Returns true if `lhs` is greater than `rhs`.
+  friend bool operator>(Self lhs, T rhs) { return rhs < lhs; }
+
+  /// ### `operator>`
+  ///
+  /// Returns true if `lhs` is greater than `rhs`.
+  friend bool operator>(T lhs, Self rhs) { return rhs < lhs; }
+
+  /// ### `operator<=`
+  ///
+  /// Returns true if `lhs` is less than or equal to `rhs`.
+  friend bool operator<=(Self lhs, Self rhs) { return !(lhs > rhs); }
+
+  /// ### `operator<=`
+  ///
+  /// Returns true if `lhs` is less than or equal to `rhs`.
+  friend bool operator<=(Self lhs, T rhs) { return !(lhs > rhs); }
+
+  /// ### `operator<=`
+  ///
+  /// Returns true if `lhs` is less than or equal to `rhs`.
+  friend bool operator<=(T lhs, Self rhs) { return !(lhs > rhs); }
+
+  /// ### `operator>=`
+  ///
+  /// Returns true if `lhs` is greater than or equal to `rhs`.
+  friend bool operator>=(Self lhs, Self rhs) { return !(lhs < rhs); }
+
+  /// ### `operator>=`
+  ///
+  /// Returns true if `lhs` is greater than or equal to `rhs`.
+  friend bool operator>=(Self lhs, T rhs) { return !(lhs < rhs); }
+
+  /// ### `operator>=`
+  ///
+  /// Returns true if `lhs` is greater than or equal to `rhs`.
+  friend bool operator>=(T lhs, Self rhs) { return !(lhs < rhs); }
+
+  /// ### `operator U`
+  ///
+  /// Returns the plain `T` value as a `U`, wrapped to `U`’s range.
+  template <typename U>
+  operator U() const {
+    return static_cast<U>(value_);
+  }
+
+  /// ### `operator<<`
+  ///
+  /// Writes `self`'s value to the `ostream`, and returns the `ostream`.
+  friend std::ostream& operator<<(std::ostream& os, Self self) {
+    os << self.value_;
+    return os;
+  }
+
+  /// ### `abs`
+  ///
+  /// Returns the absolute value of `x`, wrapping. (The absolute value of the
+  /// minimum value of a signed `T` is itself.)
+  friend Self abs(Self x) {
+    if constexpr (std::is_unsigned_v<T>) {
+      return x;
+    } else {
+      return x < T{0} ? -x : x;
+    }
+  }
+
  private:
+  // Converts back from `Unsigned`, keeping the low bits. (This is
+  // implementation-defined before C++20, but 2’s complement everywhere.)
+  static T Wrap(Unsigned x) { return static_cast<T>(x); }
+
   T value_;
 };
 
+static_assert(std::is_trivial_v<wrapping<int>>,
+              "`wrapping<T>` must be trivial");
 static_assert(sizeof(wrapping<int8_t>) == sizeof(int8_t),
               "sizeof(wrapping<int8_t>) must == sizeof(int8_t)");
 static_assert(sizeof(wrapping<int16_t>) == sizeof(int16_t),
@@ -125,6 +736,127 @@ static_assert(sizeof(wrapping<int32_t>) == sizeof(int32_t),
 static_assert(sizeof(wrapping<int64_t>) == sizeof(int64_t),
               "sizeof(wrapping<int64_t>) must == sizeof(int64_t)");
 
+/// ### `as_wrapping`
+///
+/// Returns a view of `values` as `wrapping<T>`s, without copying. See
+/// `as_trapping`.
+template <typename T>
+span<internal::rewrapped_t<wrapping, T>> as_wrapping(span<T> values) {
+  return internal::span_cast<internal::rewrapped_t<wrapping, T>>(values);
+}
+
+/// ### `as_underlying`
+///
+/// Returns a view of `values` as plain `T`s, without copying. The inverse of
+/// `as_wrapping`.
+template <typename T>
+span<T> as_underlying(span<wrapping<T>> values) {
+  return internal::span_cast<T>(values);
+}
+
+/// ### `as_underlying`
+///
+/// Returns a view of `values` as plain `T`s, without copying. The inverse of
+/// `as_wrapping`.
+template <typename T>
+span<const T> as_underlying(span<const wrapping<T>> values) {
+  return internal::span_cast<const T>(values);
+}
+
+/// ## Bit Operations
+///
+/// These functions give `wrapping<T>` the operations of `<bit>`, which take
+/// only plain unsigned types, and the wide multiplications that hashes such as
+/// xxHash and wyhash are built from. Each forwards to a compiler builtin (or
+/// to a pattern that compilers recognize), so hashes written in
+/// `wrapping<uint64_t>` compile to the same instructions as those written in
+/// `uint64_t`. Except for `byteswap`, `T` must be unsigned.
+///
+/// ### `rotl`
+///
+/// Returns `x` rotated left by `count` bits, modulo the number of bits in
+/// `T`. (A negative `count` rotates right.)
+template <typename T>
+wrapping<T> rotl(wrapping<T> x, int count) {
+  static_assert(std::is_unsigned_v<T>, "Rotations take unsigned types.");
+  return wrapping<T>(
+      internal::rotate_left(static_cast<T>(x), static_cast<unsigned>(count)));
+}
+
+/// ### `rotr`
+///
+/// Returns `x` rotated right by `count` bits, modulo the number of bits in
+/// `T`. (A negative `count` rotates left.)
+template <typename T>
+wrapping<T> rotr(wrapping<T> x, int count) {
+  static_assert(std::is_unsigned_v<T>, "Rotations take unsigned types.");
+  return wrapping<T>(internal::rotate_left(
+      static_cast<T>(x), 0u - static_cast<unsigned>(count)));
+}
+
+/// ### `byteswap`
+///
+/// Returns `x` with its bytes in reverse order.
+template <typename T>
+wrapping<T> byteswap(wrapping<T> x) {
+  return wrapping<T>(internal::reverse_bytes(static_cast<T>(x)));
+}
+
+/// ### `popcount`
+///
+/// Returns the number of 1 bits in `x`.
+template <typename T>
+int popcount(wrapping<T> x) {
+  static_assert(std::is_unsigned_v<T>, "popcount takes unsigned types.");
+  return __builtin_popcountll(static_cast<T>(x));
+}
+
+/// ### `countl_zero`
+///
+/// Returns the number of consecutive 0 bits in `x`, starting from the most
+/// significant bit. (This is the number of bits in `T` if `x` is 0.)
+template <typename T>
+int countl_zero(wrapping<T> x) {
+  static_assert(std::is_unsigned_v<T>, "countl_zero takes unsigned types.");
+  constexpr int kBits = std::numeric_limits<T>::digits;
+  const T bits = static_cast<T>(x);
+  return bits == 0 ? kBits : __builtin_clzll(bits) - (64 - kBits);
+}
+
+/// ### `countr_zero`
+///
+/// Returns the number of consecutive 0 bits in `x`, starting from the least
+/// significant bit. (This is the number of bits in `T` if `x` is 0.)
+template <typename T>
+int countr_zero(wrapping<T> x) {
+  static_assert(std::is_unsigned_v<T>, "countr_zero takes unsigned types.");
+  const T bits = static_cast<T>(x);
+  return bits == 0 ? std::numeric_limits<T>::digits : __builtin_ctzll(bits);
+}
+
+/// ### `mul_high`
+///
+/// Returns the high half of the full, double-width product of `x` and `y`.
+/// (`x * y` is the low half.) For `uint64_t`, this is one `mul` on x86-64
+/// and `umulh` on ARM64.
+template <typename T>
+wrapping<T> mul_high(wrapping<T> x, wrapping<T> y) {
+  static_assert(std::is_unsigned_v<T>, "mul_high takes unsigned types.");
+  return wrapping<T>(
+      internal::multiply_high(static_cast<T>(x), static_cast<T>(y)));
+}
+
+/// ### `mul_fold`
+///
+/// Returns the high half of the full product of `x` and `y` XORed with its
+/// low half: the folded multiply that mixes the bits of wyhash and similar
+/// hashes.
+template <typename T>
+wrapping<T> mul_fold(wrapping<T> x, wrapping<T> y) {
+  static_assert(std::is_unsigned_v<T>, "mul_fold takes unsigned types.");
+  return mul_high(x, y) ^ (x * y);
+}
+
 }  // namespace integers
 
 #endif  // WRAPPING_H_
@@ -14,6 +14,8 @@
 
 #include <iostream>
 #include <limits>
+#include <sstream>
+#include <vector>
 
 #include "test_support.h"
 #include "wrapping.h"
@@ -21,4 +23,216 @@
 using namespace integers;
 using namespace std;
 
-int main() {}
+namespace {
+
+using i8 = int8_t;
+using u8 = uint8_t;
+using i16 = int16_t;
+using u16 = uint16_t;
+using i32 = int32_t;
+using u32 = uint32_t;
+using i64 = int64_t;
+using u64 = uint64_t;
+
+// The helpers must agree with `u64` arithmetic, which wraps by definition,
+// truncated to `T`.
+template <typename T>
+void GenericTestHelpers() {
+  constexpr T max = numeric_limits<T>::max();
+  constexpr T min = numeric_limits<T>::min();
+  const T values[] = {min, static_cast<T>(min + 1), T{0}, T{1}, T{3},
+                      static_cast<T>(max - 1), max};
+  for (const T x : values) {
+    for (const T y : values) {
+      EXPECT(static_cast<T>(u64(x) + u64(y)) == (wrapping_add<T, T, T>(x, y)));
+      EXPECT(static_cast<T>(u64(x) - u64(y)) == (wrapping_sub<T, T, T>(x, y)));
+      EXPECT(static_cast<T>(u64(x) * u64(y)) == (wrapping_mul<T, T, T>(x, y)));
+    }
+  }
+
+  EXPECT(max / 3 == (wrapping_div<T, T, T>(max, 3)));
+  EXPECT(max % 3 == (wrapping_mod<T, T, T>(max, 3)));
+  EXPECT_DEATH(static_cast<void>(wrapping_div<T, T, T>(max, 0)));
+  EXPECT_DEATH(static_cast<void>(wrapping_mod<T, T, T>(max, 0)));
+  if constexpr (is_signed_v<T>) {
+    EXPECT(min == (wrapping_div<T, T, T>(min, -1)));
+    EXPECT(0 == (wrapping_mod<T, T, T>(min, -1)));
+  }
+}
+
+template <class... T>
+void CallGenericTestHelpers() {
+  (GenericTestHelpers<T>(), ...);
+}
+
+void TestHelpers() {
+  CallGenericTestHelpers<i8, u8, i16, u16, i32, u32, i64, u64>();
+
+  // Mixed types wrap the mathematical result into `R`.
+  EXPECT(44 == (wrapping_add<i32, i32, u8>(200, 100)));
+  EXPECT(-56 == (wrapping_add<u8, u8, i8>(100, 100)));
+  EXPECT(255 == (wrapping_sub<i64, i64, u8>(0, 1)));
+  EXPECT(0 == (wrapping_mul<u32, u32, u16>(65536, 3)));
+  EXPECT(150 == (wrapping_div<i32, i32, u8>(300, 2)));
+  EXPECT(128 == (wrapping_div<i8, i32, i32>(-128, -1)));
+}
+
+template <typename T>
+void GenericTestWrapping() {
+  using W = wrapping<T>;
+  constexpr T max = numeric_limits<T>::max();
+  constexpr T min = numeric_limits<T>::min();
+
+  W x{max};
+  x += W{T{1}};
+  EXPECT(W{min} == x);
+  x -= W{T{1}};
+  EXPECT(W{max} == x);
+  EXPECT(W{static_cast<T>(u64(max) * 2)} == x * W{T{1}} + x);
+  EXPECT(W{min} == ++x);
+  EXPECT(W{min} == x--);
+  EXPECT(W{max} == x);
+  EXPECT(W{static_cast<T>(0 - u64(min))} == -W{min});
+  EXPECT(W{static_cast<T>(~max)} == ~x);
+
+  EXPECT(W{T{1}} == W{T{7}} % W{T{3}});
+  EXPECT(W{T{2}} == W{T{7}} / W{T{3}});
+  EXPECT_DEATH(static_cast<void>(W{T{7}} / W{T{0}}));
+
+  // Narrowing conversions wrap, too.
+  EXPECT(W{static_cast<T>(u64{0x123456789ABCDEF0})} ==
+         W{u64{0x123456789ABCDEF0}});
+  EXPECT(static_cast<u8>(0xF0) == static_cast<u8>(W{u64{0x123456789ABCDEF0}}));
+
+  // Shift counts wrap modulo the number of bits.
+  constexpr int bits = numeric_limits<make_unsigned_t<T>>::digits;
+  EXPECT(W{T{2}} == (W{T{1}} << (bits + 1)));
+  EXPECT(W{T{0}} == (W{T{1}} << (bits - 1)) << 1);
+  EXPECT(W{T{1}} == (W{T{2}} >> (bits + 1)));
+  EXPECT((W{T{6}} & W{T{3}}) == W{T{2}});
+  EXPECT((W{T{6}} | W{T{3}}) == W{T{7}});
+  EXPECT((W{T{6}} ^ W{T{3}}) == W{T{5}});
+  EXPECT(W{T{1}} < W{T{2}});
+  EXPECT(W{T{1}} != W{T{2}});
+
+  // Operands of other types wrap to `T`.
+  EXPECT(W{T{2}} == (W{T{6}} & 0x103));
+  EXPECT(W{T{7}} == (u64{4} | W{T{3}}));
+  EXPECT(W{T{5}} == (W{T{6}} ^ u64{3}));
+  EXPECT(W{T{3}} == W{T{7}} / 2);
+  EXPECT(W{T{1}} == 7 % W{T{2}});
+  EXPECT(W{T{3}} == +W{T{3}});
+
+  const W one{T{1}};
+  const W two{T{2}};
+  EXPECT(two > one && two >= one && one <= two && !(one >= two));
+  EXPECT(one <= one && one >= one && !(one > one));
+  EXPECT(one < T{2} && T{2} > one && one <= T{1} && T{1} >= one);
+  EXPECT(W{max} > W{min});
+
+  EXPECT(two == abs(two));
+  if constexpr (is_signed_v<T>) {
+    EXPECT(two == abs(-two));
+    EXPECT(W{min} == abs(W{min}));
+    EXPECT(W{min} == W{min} / -1);
+  }
+}
+
+template <class... T>
+void CallGenericTestWrapping() {
+  (GenericTestWrapping<T>(), ...);
+}
+
+void TestWrapping() {
+  CallGenericTestWrapping<i8, u8, i16, u16, i32, u32, i64, u64>();
+
+  // Arithmetic on narrow types is not promoted to `int`.
+  wrapping<u16> x{u16{65535}};
+  x *= x;
+  EXPECT(wrapping<u16>{u16{1}} == x);
+  EXPECT(wrapping<i8>{i8{-1}} == wrapping<i8>{i8{-128}} >> 7);
+
+  ostringstream out;
+  out << wrapping<i32>{-42};
+  EXPECT("-42" == out.str());
+}
+
+void TestViews() {
+  vector<u32> column{1, 2, numeric_limits<u32>::max()};
+  for (wrapping<u32>& x : as_wrapping<u32>(column)) {
+    x += wrapping<u32>{1u};
+  }
+  EXPECT(2 == column[0]);
+  EXPECT(0 == column[2]);
+
+  const span<const wrapping<u32>> view = as_wrapping<const u32>(column);
+  EXPECT(static_cast<const void*>(column.data()) == view.data());
+  EXPECT(column.size() == view.size());
+  EXPECT(wrapping<u32>{3u} == view[1]);
+  EXPECT(column.data() == as_underlying(view).data());
+  EXPECT(column.data() == as_underlying(as_wrapping<u32>(column)).data());
+}
+
+template <typename T>
+void GenericTestBitOperations() {
+  using W = wrapping<T>;
+  constexpr int bits = numeric_limits<T>::digits;
+  constexpr T max = numeric_limits<T>::max();
+  const W high{static_cast<T>(T{1} << (bits - 1))};
+
+  EXPECT(W{T{1}} == rotl(high, 1));
+  EXPECT(high == rotr(W{T{1}}, 1));
+  EXPECT(W{T{2}} == rotl(high, bits + 2));
+  EXPECT(W{T{1}} == rotl(W{T{2}}, -1));
+  EXPECT(W{T{4}} == rotr(W{T{1}}, -2));
+  EXPECT(W{T{6}} == rotl(W{T{6}}, 0));
+  EXPECT(W{T{1}} == rotr(high, numeric_limits<int>::min() + bits - 1));
+
+  EXPECT(0 == popcount(W{T{0}}));
+  EXPECT(bits == popcount(W{max}));
+  EXPECT(2 == popcount(W{T{5}}));
+  EXPECT(bits == countl_zero(W{T{0}}));
+  EXPECT(0 == countl_zero(high));
+  EXPECT(bits - 3 == countl_zero(W{T{5}}));
+  EXPECT(bits == countr_zero(W{T{0}}));
+  EXPECT(bits - 1 == countr_zero(high));
+  EXPECT(2 == countr_zero(W{T{12}}));
+
+  EXPECT(W{T{1}} == byteswap(W{static_cast<T>(T{1} << (bits - 8))}));
+  EXPECT(W{max} == byteswap(W{max}));
+
+  // The full product of the maximum with itself is (2**bits - 2) * 2**bits +
+  // 1.
+  EXPECT(W{static_cast<T>(max - 1)} == mul_high(W{max}, W{max}));
+  EXPECT(W{T{0}} == mul_high(W{max}, W{T{1}}));
+  EXPECT(W{T{1}} == mul_high(high, W{T{2}}));
+  EXPECT(W{static_cast<T>((max - 1) ^ 1)} == mul_fold(W{max}, W{max}));
+}
+
+template <class... T>
+void CallGenericTestBitOperations() {
+  (GenericTestBitOperations<T>(), ...);
+}
+
+void TestBitOperations() {
+  CallGenericTestBitOperations<u8, u16, u32, u64>();
+
+  EXPECT(wrapping<i16>{i16{0x0180}} == byteswap(wrapping<i16>{i16{-32767}}));
+  EXPECT(wrapping<u64>{0x0123456789ABCDEFu} ==
+         byteswap(wrapping<u64>{0xEFCDAB8967452301u}));
+  EXPECT(wrapping<u64>{0x0000000000000001u} ==
+         mul_high(wrapping<u64>{0x0000000100000000u},
+                  wrapping<u64>{0x0000000100000000u}));
+  EXPECT(wrapping<u64>{0x0121FA00AD77D742u} ==
+         mul_high(wrapping<u64>{0x0123456789ABCDEFu},
+                  wrapping<u64>{0xFEDCBA9876543210u}));
+}
+
+}  // namespace
+
+int main() {
+  TestHelpers();
+  TestWrapping();
+  TestViews();
+  TestBitOperations();
+}